@@ -0,0 +1,336 @@
+// Fast_Random.h : Random engines and distributions shared by all the simulators.
+//
+/*
+rand() is slow, takes a lock in some C libraries, has a small range (RAND_MAX can be 32767) and
+poor low bits, so "rand() % n" is both biased and badly distributed. The engines here are small,
+fast and statistically strong; all of them satisfy UniformRandomBitGenerator, so they also work
+with <random> and <algorithm>.
+
+- splitmix64:   64-bit state, one multiply-xorshift finaliser per output. Used to expand seeds.
+- xoshiro256ss: xoshiro256** (Blackman and Vigna), period 2^256 - 1, the default engine.
+                jump() advances 2^128 steps, so stream(seed, i) gives non-overlapping streams.
+- pcg32:        PCG-XSH-RR 64/32 (O'Neill), 32-bit output; each odd increment selects one of
+                2^63 distinct streams.
+- philox4x32:   Philox4x32-10 (Salmon et al.), counter-based: output n of stream s is a pure
+                function of (key, s, n), so work can be split at any point without passing state
+                around, and results do not depend on how trials are spread over threads.
+
+Distributions work with any of these (and with std::mt19937 / std::mt19937_64):
+- bounded_rand(rng, n): unbiased integer in [0, n) by Lemire's multiply-and-reject, which needs
+  a division only in the rare rejection case;
+- uniform_int(rng, lo, hi), uniform_double(rng) in [0, 1), shuffle_range(first, last, rng).
+
+thread_rng() hands every thread its own xoshiro256** stream of one common seed (see
+seed_thread_rngs), for code that cannot easily take an engine parameter.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// SplitMix64 step: advances 'state' and returns the next output
+inline uint64_t split_mix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+class splitmix64 {
+public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    explicit splitmix64(uint64_t seed = 1) : state(seed) {}
+
+    result_type operator()() { return split_mix64(state); }
+
+private:
+    uint64_t state;
+};
+
+class xoshiro256ss {
+public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    explicit xoshiro256ss(uint64_t seed = 1) {
+        for (auto& w : s)
+            w = split_mix64(seed);
+    }
+
+    // Stream 'index' of 'seed': the seed's sequence jumped index * 2^128 steps ahead (O(index))
+    static xoshiro256ss stream(uint64_t seed, uint64_t index) {
+        xoshiro256ss rng(seed);
+        for (uint64_t i = 0; i < index; ++i)
+            rng.jump();
+        return rng;
+    }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Advance by 2^128 steps: equivalent to 2^128 calls of operator()
+    void jump() {
+        static const uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                         0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        uint64_t t[4] = { 0, 0, 0, 0 };
+        for (uint64_t j : JUMP) {
+            for (int b = 0; b < 64; ++b) {
+                if (j & (1ULL << b))
+                    for (int i = 0; i < 4; ++i)
+                        t[i] ^= s[i];
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i)
+            s[i] = t[i];
+    }
+
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+class pcg32 {
+public:
+    using result_type = uint32_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    explicit pcg32(uint64_t seed = 1, uint64_t stream = 0) : state(0), inc((stream << 1) | 1) {
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+    }
+
+private:
+    uint64_t state;
+    uint64_t inc;
+};
+
+class philox4x32 {
+public:
+    using result_type = uint64_t;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    // Stream 'stream' of key 'seed', positioned at its output 'position'
+    explicit philox4x32(uint64_t seed = 1, uint64_t stream = 0, uint64_t position = 0)
+        : key{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }, stream_id(stream) {
+        seek(position);
+    }
+
+    // Jump to output number 'position' of the stream (two outputs per block)
+    void seek(uint64_t position) {
+        block = position / 2;
+        refill();
+        index = static_cast<int>(position % 2);
+    }
+
+    result_type operator()() {
+        if (index == 2) {
+            ++block;
+            refill();
+            index = 0;
+        }
+        return out[index++];
+    }
+
+    // The raw generator: 128 random bits for counter (c0, c1, c2, c3) and key (k0, k1)
+    static void generate(uint32_t c[4], uint32_t k0, uint32_t k1) {
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+            uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c[1] ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c[3] ^ k1;
+            c[1] = static_cast<uint32_t>(p1);
+            c[3] = static_cast<uint32_t>(p0);
+            c[0] = n0;
+            c[2] = n2;
+            k0 += 0x9E3779B9u;
+            k1 += 0xBB67AE85u;
+        }
+    }
+
+private:
+    uint32_t key[2];
+    uint64_t stream_id;
+    uint64_t block = 0;
+    uint64_t out[2] = { 0, 0 };
+    int index = 0;
+
+    void refill() {
+        uint32_t c[4] = { static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+                          static_cast<uint32_t>(stream_id), static_cast<uint32_t>(stream_id >> 32) };
+        generate(c, key[0], key[1]);
+        out[0] = (static_cast<uint64_t>(c[1]) << 32) | c[0];
+        out[1] = (static_cast<uint64_t>(c[3]) << 32) | c[2];
+    }
+};
+
+namespace random_detail {
+
+template <class Engine>
+using is_64bit = std::integral_constant<bool, (Engine::max() == ~static_cast<uint64_t>(0))>;
+
+template <class Engine>
+void check_full_range() {
+    static_assert(Engine::min() == 0 && (Engine::max() == 0xFFFFFFFFULL || Engine::max() == ~static_cast<uint64_t>(0)),
+                  "engines must return full 32- or 64-bit words");
+}
+
+template <class Engine>
+uint64_t bits64(Engine& rng, std::true_type) { return rng(); }
+
+template <class Engine>
+uint64_t bits64(Engine& rng, std::false_type) {
+    uint64_t high = static_cast<uint32_t>(rng());
+    return (high << 32) | static_cast<uint32_t>(rng());
+}
+
+// High 64 bits of a * b
+inline uint64_t mul_high64(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return __umulh(a, b);
+#elif defined(__SIZEOF_INT128__)
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32, b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    uint64_t mid1 = a_hi * b_lo, mid2 = a_lo * b_hi;
+    uint64_t carry = ((a_lo * b_lo >> 32) + (mid1 & 0xFFFFFFFF) + (mid2 & 0xFFFFFFFF)) >> 32;
+    return a_hi * b_hi + (mid1 >> 32) + (mid2 >> 32) + carry;
+#endif
+}
+
+} // namespace random_detail
+
+// 32 random bits
+template <class Engine>
+inline uint32_t random_bits32(Engine& rng) {
+    random_detail::check_full_range<Engine>();
+    return static_cast<uint32_t>(rng());
+}
+
+// 64 random bits (two calls of a 32-bit engine)
+template <class Engine>
+inline uint64_t random_bits64(Engine& rng) {
+    random_detail::check_full_range<Engine>();
+    return random_detail::bits64(rng, random_detail::is_64bit<Engine>());
+}
+
+// Unbiased integer in [0, range), range >= 1 (Lemire's multiply-and-reject method)
+template <class Engine>
+inline uint32_t bounded_rand(Engine& rng, uint32_t range) {
+    uint64_t m = static_cast<uint64_t>(random_bits32(rng)) * range;
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < range) {
+        uint32_t threshold = (0u - range) % range;
+        while (low < threshold) {
+            m = static_cast<uint64_t>(random_bits32(rng)) * range;
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
+// Unbiased integer in [0, range) for 64-bit ranges, range >= 1
+template <class Engine>
+inline uint64_t bounded_rand64(Engine& rng, uint64_t range) {
+    if (range <= 0xFFFFFFFFULL)
+        return bounded_rand(rng, static_cast<uint32_t>(range));
+    uint64_t x = random_bits64(rng);
+    uint64_t low = x * range;
+    if (low < range) {
+        uint64_t threshold = (0 - range) % range;
+        while (low < threshold) {
+            x = random_bits64(rng);
+            low = x * range;
+        }
+    }
+    return random_detail::mul_high64(x, range);
+}
+
+// Unbiased integer in [lo, hi]
+template <class Engine>
+inline int64_t uniform_int(Engine& rng, int64_t lo, int64_t hi) {
+    uint64_t span = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo);
+    if (span == ~static_cast<uint64_t>(0))
+        return static_cast<int64_t>(random_bits64(rng));
+    return static_cast<int64_t>(static_cast<uint64_t>(lo) + bounded_rand64(rng, span + 1));
+}
+
+// Uniform double in [0, 1) with all 53 bits of the mantissa random
+template <class Engine>
+inline double uniform_double(Engine& rng) {
+    return static_cast<double>(random_bits64(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform double in [lo, hi)
+template <class Engine>
+inline double uniform_double(Engine& rng, double lo, double hi) {
+    return lo + (hi - lo) * uniform_double(rng);
+}
+
+// Fisher-Yates shuffle of a random-access range
+template <class RandomAccess, class Engine>
+inline void shuffle_range(RandomAccess first, RandomAccess last, Engine& rng) {
+    auto n = last - first;
+    for (decltype(n) i = n - 1; i > 0; --i) {
+        auto j = static_cast<decltype(n)>(bounded_rand64(rng, static_cast<uint64_t>(i) + 1));
+        std::swap(first[i], first[j]);
+    }
+}
+
+namespace random_detail {
+
+inline std::atomic<uint64_t>& thread_seed() {
+    static std::atomic<uint64_t> seed(0x5EEDULL);
+    return seed;
+}
+
+inline std::atomic<uint64_t>& next_thread_stream() {
+    static std::atomic<uint64_t> next(0);
+    return next;
+}
+
+} // namespace random_detail
+
+// Seed of the thread_rng() streams; threads that already drew keep their engine
+inline void seed_thread_rngs(uint64_t seed) {
+    random_detail::thread_seed() = seed;
+    random_detail::next_thread_stream() = 0;
+}
+
+// The calling thread's engine: stream k of the common seed for the k-th thread that asks
+inline xoshiro256ss& thread_rng() {
+    thread_local xoshiro256ss rng = xoshiro256ss::stream(random_detail::thread_seed(), random_detail::next_thread_stream()++);
+    return rng;
+}
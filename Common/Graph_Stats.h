@@ -0,0 +1,98 @@
+// Graph_Stats.h : Operation counters and phase timings for the shortest path and spanning tree searches.
+//
+/*
+Both searches run on a dense adjacency matrix: every settled node scans its whole row, whether it
+has 3 neighbours or 3000. Whether a sparse representation would pay off depends on how many of
+those scans find an edge, and how much of the time goes into the heap rather than the scans.
+graph_stats records, for the last search of a graph:
+
+- heap_pushes / heap_pops: priority queue operations
+- stale_pops:    popped entries whose node was already settled with a lower cost (lazy deletion
+                 pushes a node again instead of decreasing its key, so every improvement leaves
+                 one such entry behind)
+- nodes_settled: nodes whose final cost was known when popped
+- edges_scanned: matrix entries read while settling nodes (nodes_settled * V for a matrix)
+- edges_found:   of these, the ones that are edges (what an adjacency list would read)
+- relaxations:   edges that improved a tentative cost
+- init / search / output seconds: setting up the arrays, the main loop, and reporting the result
+
+Counting is compiled in only with GRAPH_STATS defined to 1 (/DGRAPH_STATS=1, or
+-DGRAPH_STATS=1); otherwise GRAPH_STAT(...) expands to nothing, so the searches are exactly as
+fast as without it, and graph_stats::enabled is false. write_json prints one JSON object, e.g.
+to compare runs on different graphs with a script.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ios>
+#include <ostream>
+
+#ifndef GRAPH_STATS
+#define GRAPH_STATS 0
+#endif
+
+// GRAPH_STAT(statement); runs the statement (it may be a declaration) only when counting
+#if GRAPH_STATS
+#define GRAPH_STAT(statement) statement
+#else
+#define GRAPH_STAT(statement)
+#endif
+
+struct graph_stats {
+    static constexpr bool enabled = GRAPH_STATS != 0;
+
+    const char* algorithm = "";
+    int nodes = 0;
+    uint64_t heap_pushes = 0;
+    uint64_t heap_pops = 0;
+    uint64_t stale_pops = 0;
+    uint64_t nodes_settled = 0;
+    uint64_t edges_scanned = 0;
+    uint64_t edges_found = 0;
+    uint64_t relaxations = 0;
+    double init_seconds = 0.0;
+    double search_seconds = 0.0;
+    double output_seconds = 0.0;
+
+    void reset(const char* name, int n) {
+        *this = graph_stats();
+        algorithm = name;
+        nodes = n;
+    }
+
+    // Fraction of the scanned matrix entries that were edges
+    double edge_density() const { return edges_scanned ? double(edges_found) / edges_scanned : 0.0; }
+
+    // Written with the default float format, whatever the stream was set to before
+    void write_json(std::ostream& out) const {
+        const std::ios_base::fmtflags flags = out.flags();
+        const std::streamsize precision = out.precision(9);
+        out.unsetf(std::ios_base::floatfield);
+        out << "{\"algorithm\": \"" << algorithm << "\", \"enabled\": " << (enabled ? "true" : "false")
+            << ", \"nodes\": " << nodes
+            << ", \"heap_pushes\": " << heap_pushes << ", \"heap_pops\": " << heap_pops
+            << ", \"stale_pops\": " << stale_pops << ", \"nodes_settled\": " << nodes_settled
+            << ", \"edges_scanned\": " << edges_scanned << ", \"edges_found\": " << edges_found
+            << ", \"relaxations\": " << relaxations << ", \"edge_density\": " << edge_density()
+            << ", \"seconds\": {\"init\": " << init_seconds << ", \"search\": " << search_seconds
+            << ", \"output\": " << output_seconds << "}}";
+        out.flags(flags);
+        out.precision(precision);
+    }
+};
+
+// Adds the time since the previous lap (or construction) to a phase total
+class graph_phase_clock {
+public:
+    graph_phase_clock() : last(std::chrono::steady_clock::now()) {}
+
+    void lap(double& seconds) {
+        auto now = std::chrono::steady_clock::now();
+        seconds += std::chrono::duration<double>(now - last).count();
+        last = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last;
+};
@@ -1,12 +1,20 @@
 #include <iostream>
-#include <cstdlib> // For rand() and srand()
+#include <cstdlib>
 #include <ctime>   // For time()
 
+#include "../../Common/Fast_Random.h"
+
 using namespace std;
 
-// Function to generate a random probability between 0 and 1
+// Function to generate a random probability in [0, 1) from the given engine
+template <class Engine>
+double prob(Engine& rng) {
+    return uniform_double(rng);
+}
+
+// Same, from the calling thread's engine (seeded in main)
 double prob() {
-    return static_cast<double>(rand()) / RAND_MAX;
+    return prob(thread_rng());
 }
 
 // Function to check if the graph is connected
@@ -65,7 +73,7 @@ int main() {
     double density = 0.89; // Density of edges in the graph
 
     // Seed the random number generator
-    srand(time(0));
+    seed_thread_rngs(static_cast<uint64_t>(time(0)));
 
     // Dynamically allocate a 2D array of booleans (adjacency matrix)
     bool** graph = new bool* [size];
@@ -1,5 +1,11 @@
 #include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include <string>
 #include <vector>
+
+#include "Prefix_Sum.h"
 using namespace std; // Use the standard namespace
 
 const int N = 40; // Replace #define with const
@@ -7,12 +13,91 @@ const int N = 40; // Replace #define with const
 // Inline function definition for sum
 inline void sum(int* p, int n, const vector<int>&d) {
     int i;
-    *p = 0;
+    int s = 0; // Accumulate in a local, which stays in a register, and store once
     for (i = 0; i < n; ++i)
-        *p += d[i]; // Accumulate the sum
+        s += d[i]; // Accumulate the sum
+    *p = s;
+}
+
+volatile long long sink; // Benchmark results are stored here so that they are not optimized away
+
+// Best of 'repeats' runs of f, in GB/s for 'bytes' of memory traffic per run
+template <class F>
+double gigabytes_per_second(size_t bytes, int repeats, F f) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+    }
+    return bytes / best / 1e9;
+}
+
+// Usage: CumSum bench [elements] [threads]
+int run_benchmark(int argc, char* argv[]) {
+    size_t n = argc > 2 ? strtoull(argv[2], 0, 10) : (1 << 26);
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    const int REPEATS = 5;
+
+    vector<int> data(n);
+    for (size_t i = 0; i < n; ++i)
+        data[i] = static_cast<int>(i * 2654435761u % 2001) - 1000;
+    vector<long long> wide(n), check(n);
+    vector<int> narrow(n);
+    long long expected = 0;
+    for (size_t i = 0; i < n; ++i)
+        check[i] = expected += data[i];
+
+    cout << n << " ints (" << n * sizeof(int) / 1e6 << " MB), " << scan_detail::thread_count(n, threads)
+        << " threads for the parallel versions, best of " << REPEATS << endl;
+#if defined(__AVX2__)
+    cout << "AVX2 kernels" << endl;
+#else
+    cout << "scalar kernels" << endl;
+#endif
+
+    // Reductions read 4 bytes per element
+    long long r = 0;
+    int r32 = 0;
+    cout << "reduce (GB/s read)" << endl;
+    cout << "  sum(), int                          " << gigabytes_per_second(n * 4, REPEATS, [&] { sum(&r32, static_cast<int>(n), data); sink = r32; }) << endl;
+    cout << "  std::accumulate, int                " << gigabytes_per_second(n * 4, REPEATS, [&] { r32 = accumulate(data.begin(), data.end(), 0); sink = r32; }) << endl;
+    cout << "  std::accumulate, long long          " << gigabytes_per_second(n * 4, REPEATS, [&] { r = accumulate(data.begin(), data.end(), 0LL); sink = r; }) << endl;
+    cout << "  reduce_n, int                       " << gigabytes_per_second(n * 4, REPEATS, [&] { r32 = reduce_n(data.data(), n, 0); sink = r32; }) << endl;
+    cout << "  reduce_n, long long                 " << gigabytes_per_second(n * 4, REPEATS, [&] { r = reduce_n(data.data(), n); sink = r; }) << endl;
+    if (r != expected)
+        cout << "  wrong sum " << r << " instead of " << expected << endl;
+    cout << "  parallel_reduce_n, long long        " << gigabytes_per_second(n * 4, REPEATS, [&] { r = parallel_reduce_n(data.data(), n, threads); sink = r; }) << endl;
+    if (r != expected)
+        cout << "  wrong sum " << r << " instead of " << expected << endl;
+
+    // Scans read 4 bytes and write 4 or 8 per element
+    cout << "scan (GB/s read + written)" << endl;
+    cout << "  std::partial_sum, int               " << gigabytes_per_second(n * 8, REPEATS, [&] { partial_sum(data.begin(), data.end(), narrow.begin()); }) << endl;
+    cout << "  std::partial_sum, long long         " << gigabytes_per_second(n * 12, REPEATS, [&] { partial_sum(data.begin(), data.end(), wide.begin(), plus<long long>()); }) << endl;
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L
+    cout << "  std::inclusive_scan, long long      " << gigabytes_per_second(n * 12, REPEATS, [&] { std::inclusive_scan(data.begin(), data.end(), wide.begin(), plus<long long>(), 0LL); }) << endl;
+#endif
+    cout << "  inclusive_scan_n, int               " << gigabytes_per_second(n * 8, REPEATS, [&] { inclusive_scan_n(data.data(), narrow.data(), n, 0); }) << endl;
+    cout << "  inclusive_scan_n, long long         " << gigabytes_per_second(n * 12, REPEATS, [&] { inclusive_scan_n(data.data(), wide.data(), n); }) << endl;
+    if (wide != check)
+        cout << "  wrong inclusive scan" << endl;
+    cout << "  parallel_inclusive_scan_n           " << gigabytes_per_second(n * 12, REPEATS, [&] { parallel_inclusive_scan_n(data.data(), wide.data(), n, threads); }) << endl;
+    if (wide != check)
+        cout << "  wrong parallel inclusive scan" << endl;
+    cout << "  parallel_exclusive_scan_n           " << gigabytes_per_second(n * 12, REPEATS, [&] { parallel_exclusive_scan_n(data.data(), wide.data(), n, threads); }) << endl;
+    for (size_t i = 0; i < n; ++i)
+        if (wide[i] != check[i] - data[i]) {
+            cout << "  wrong parallel exclusive scan at " << i << endl;
+            break;
+        }
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "bench")
+        return run_benchmark(argc, argv);
+
     int accum = 0;
 
     // Use vector for dynamic arrays
@@ -28,5 +113,13 @@ int main() {
     // Use C++ I/O instead of printf
     cout << "Sum is " << accum << endl;
 
+    // Cumulative sums of the same data
+    vector<long long> cumulative(N);
+    inclusive_scan_n(data.data(), cumulative.data(), N);
+    cout << "Cumulative sums:";
+    for (long long c : cumulative)
+        cout << " " << c;
+    cout << endl;
+
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,300 @@
+// Prefix_Sum.h : Reductions and inclusive / exclusive prefix sums, AVX2 and multi-threaded.
+//
+/*
+reduce_n(data, n) is the sum of the elements; inclusive_scan_n(in, out, n) writes out[i] =
+in[0] + ... + in[i], exclusive_scan_n out[i] = init + in[0] + ... + in[i - 1]. All three take
+any associative (and, for reduce, commutative) operation and an initial value, like the std
+versions, but a pointer and a count instead of an iterator range (hence _n, as in copy_n).
+
+The accumulator is wider than the data by default (wide_t<T>: int sums into long long, float
+into double), so summing millions of ints does not overflow; pass Acc = T to keep the narrow
+type when the sums are known to fit. With std::plus on a signed integer accumulator every kernel,
+vector or not, adds in the matching unsigned type, so a sum that does overflow wraps around
+(two's complement) instead of being undefined.
+
+Kernels: the generic versions keep the running value in a local (a register), and reduce splits
+it over four independent accumulators so the additions do not wait on each other. With AVX2
+(x64 builds set /arch:AVX2) int -> long long and int -> int sums get vector kernels:
+- reduce widens 4 ints to 4 int64 lanes per step, over 4 registers
+- scan does the log-step prefix inside a register (add the register shifted by 1, then by 2
+  lanes, ...) and adds the running carry. The carry grows by the register's last lane; it is
+  the only value passed from step to step, so the chain between steps is a single add
+
+parallel_reduce_n / parallel_inclusive_scan_n / parallel_exclusive_scan_n split the range over threads
+in contiguous chunks. A scan takes two passes: each thread first reduces its chunk, the chunk
+totals are scanned serially into per-chunk offsets, then each thread scans its chunk starting
+from its offset. Ranges under PARALLEL_GRAIN elements per thread run on fewer threads.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Accumulator type used by default for data of type T
+template <class T> struct wide_accumulator { typedef T type; };
+template <> struct wide_accumulator<signed char> { typedef long long type; };
+template <> struct wide_accumulator<short> { typedef long long type; };
+template <> struct wide_accumulator<int> { typedef long long type; };
+template <> struct wide_accumulator<long> { typedef long long type; };
+template <> struct wide_accumulator<unsigned char> { typedef unsigned long long type; };
+template <> struct wide_accumulator<unsigned short> { typedef unsigned long long type; };
+template <> struct wide_accumulator<unsigned int> { typedef unsigned long long type; };
+template <> struct wide_accumulator<unsigned long> { typedef unsigned long long type; };
+template <> struct wide_accumulator<float> { typedef double type; };
+
+template <class T> using wide_t = typename wide_accumulator<T>::type;
+
+const size_t PARALLEL_GRAIN = 1 << 16;   // fewest elements worth a thread
+
+namespace scan_detail {
+
+    // op(a, b); std::plus on a signed integer type adds in the unsigned type, so overflow wraps
+    template <class Acc, class Op, class = void>
+    struct combiner {
+        static Acc apply(Op& op, Acc a, Acc b) { return op(a, b); }
+    };
+
+    template <class Acc>
+    struct combiner<Acc, std::plus<Acc>, typename std::enable_if<std::is_integral<Acc>::value && std::is_signed<Acc>::value>::type> {
+        static Acc apply(std::plus<Acc>&, Acc a, Acc b) {
+            typedef typename std::make_unsigned<Acc>::type U;
+            return static_cast<Acc>(static_cast<U>(a) + static_cast<U>(b));
+        }
+    };
+
+    template <class Acc, class Op>
+    inline Acc combine(Op& op, Acc a, Acc b) { return combiner<Acc, Op>::apply(op, a, b); }
+
+    // Generic kernels: any T, accumulator and operation
+    template <class T, class Acc, class Op>
+    struct kernel {
+        static Acc reduce(const T* data, size_t n, Acc init, Op op) {
+            if (n < 4) {
+                for (size_t i = 0; i < n; ++i)
+                    init = combine(op, init, static_cast<Acc>(data[i]));
+                return init;
+            }
+            Acc a0 = static_cast<Acc>(data[0]), a1 = static_cast<Acc>(data[1]);
+            Acc a2 = static_cast<Acc>(data[2]), a3 = static_cast<Acc>(data[3]);
+            size_t i = 4;
+            for (; i + 4 <= n; i += 4) {
+                a0 = combine(op, a0, static_cast<Acc>(data[i]));
+                a1 = combine(op, a1, static_cast<Acc>(data[i + 1]));
+                a2 = combine(op, a2, static_cast<Acc>(data[i + 2]));
+                a3 = combine(op, a3, static_cast<Acc>(data[i + 3]));
+            }
+            for (; i < n; ++i)
+                a0 = combine(op, a0, static_cast<Acc>(data[i]));
+            return combine(op, init, combine(op, combine(op, a0, a1), combine(op, a2, a3)));
+        }
+
+        // out[i] = carry op in[0..i] (inclusive) or carry op in[0..i-1] (exclusive); returns the
+        // carry after the last element
+        static Acc scan(const T* in, Acc* out, size_t n, Acc carry, Op op, bool inclusive) {
+            for (size_t i = 0; i < n; ++i) {
+                Acc next = combine(op, carry, static_cast<Acc>(in[i]));
+                out[i] = inclusive ? next : carry;
+                carry = next;
+            }
+            return carry;
+        }
+    };
+
+#if defined(__AVX2__)
+    inline long long horizontal_sum(__m256i v) {
+        __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        return static_cast<long long>(static_cast<unsigned long long>(_mm_cvtsi128_si64(s)) + static_cast<unsigned long long>(_mm_extract_epi64(s, 1)));
+    }
+
+    // x0, x0+x1, x0+x1+x2, x0+..+x3 of 4 int64 lanes: add x shifted by one lane, then by two
+    inline __m256i prefix4(__m256i x) {
+        const __m256i zero = _mm256_setzero_si256();
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+        return _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    }
+
+    // int data summed in long long lanes
+    template <>
+    struct kernel<int, long long, std::plus<long long>> {
+        static long long reduce(const int* data, size_t n, long long init, std::plus<long long>) {
+            __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8));
+                a0 = _mm256_add_epi64(a0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+                a1 = _mm256_add_epi64(a1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+                a2 = _mm256_add_epi64(a2, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(y)));
+                a3 = _mm256_add_epi64(a3, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(y, 1)));
+            }
+            unsigned long long total = static_cast<unsigned long long>(init) +
+                static_cast<unsigned long long>(horizontal_sum(_mm256_add_epi64(_mm256_add_epi64(a0, a1), _mm256_add_epi64(a2, a3))));
+            for (; i < n; ++i)
+                total += static_cast<unsigned long long>(data[i]);
+            return static_cast<long long>(total);
+        }
+
+        static long long scan(const int* in, long long* out, size_t n, long long carry, std::plus<long long>, bool inclusive) {
+            __m256i c = _mm256_set1_epi64x(carry);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256i x0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+                __m256i x1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4)));
+                __m256i p0 = prefix4(x0), p1 = prefix4(x1);
+                // only the carry depends on the previous step: one add per 4 elements
+                __m256i s0 = _mm256_add_epi64(p0, c);
+                c = _mm256_add_epi64(c, _mm256_permute4x64_epi64(p0, _MM_SHUFFLE(3, 3, 3, 3)));
+                __m256i s1 = _mm256_add_epi64(p1, c);
+                c = _mm256_add_epi64(c, _mm256_permute4x64_epi64(p1, _MM_SHUFFLE(3, 3, 3, 3)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), inclusive ? s0 : _mm256_sub_epi64(s0, x0));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 4), inclusive ? s1 : _mm256_sub_epi64(s1, x1));
+            }
+            unsigned long long running = static_cast<unsigned long long>(_mm256_extract_epi64(c, 0));
+            for (; i < n; ++i) {
+                unsigned long long next = running + static_cast<unsigned long long>(in[i]);
+                out[i] = static_cast<long long>(inclusive ? next : running);
+                running = next;
+            }
+            return static_cast<long long>(running);
+        }
+    };
+
+    // int data summed in int lanes
+    template <>
+    struct kernel<int, int, std::plus<int>> {
+        static int reduce(const int* data, size_t n, int init, std::plus<int>) {
+            __m256i a0 = _mm256_setzero_si256(), a1 = a0, a2 = a0, a3 = a0;
+            size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                a0 = _mm256_add_epi32(a0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+                a1 = _mm256_add_epi32(a1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 8)));
+                a2 = _mm256_add_epi32(a2, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 16)));
+                a3 = _mm256_add_epi32(a3, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 24)));
+            }
+            __m256i a = _mm256_add_epi32(_mm256_add_epi32(a0, a1), _mm256_add_epi32(a2, a3));
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+            unsigned total = static_cast<unsigned>(init) + static_cast<unsigned>(_mm_cvtsi128_si32(s));
+            for (; i < n; ++i)
+                total += static_cast<unsigned>(data[i]);
+            return static_cast<int>(total);
+        }
+
+        static int scan(const int* in, int* out, size_t n, int carry, std::plus<int>, bool inclusive) {
+            const __m256i last = _mm256_set1_epi32(7);
+            __m256i c = _mm256_set1_epi32(carry);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                // prefix inside each 128-bit half, then the low half's total into the high half
+                __m256i s = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+                s = _mm256_add_epi32(s, _mm256_slli_si256(s, 8));
+                s = _mm256_add_epi32(s, _mm256_shuffle_epi32(_mm256_permute2x128_si256(s, s, 0x08), _MM_SHUFFLE(3, 3, 3, 3)));
+                __m256i total = _mm256_permutevar8x32_epi32(s, last);
+                s = _mm256_add_epi32(s, c);
+                c = _mm256_add_epi32(c, total);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), inclusive ? s : _mm256_sub_epi32(s, x));
+            }
+            unsigned running = static_cast<unsigned>(_mm256_cvtsi256_si32(c));
+            for (; i < n; ++i) {
+                unsigned next = running + static_cast<unsigned>(in[i]);
+                out[i] = static_cast<int>(inclusive ? next : running);
+                running = next;
+            }
+            return static_cast<int>(running);
+        }
+    };
+#endif
+
+    inline int thread_count(size_t n, int threads) {
+        if (threads <= 0)
+            threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        return static_cast<int>(std::max<size_t>(1, std::min<size_t>(threads, n / PARALLEL_GRAIN)));
+    }
+
+    // Run f(t, begin, end) for the t-th of 'threads' contiguous chunks of [0, n)
+    template <class F>
+    void for_chunks(size_t n, int threads, F f) {
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; ++t)
+            pool.emplace_back(f, t, n * t / threads, n * (t + 1) / threads);
+        f(0, size_t(0), n / threads);
+        for (auto& th : pool)
+            th.join();
+    }
+
+    template <class T, class Acc, class Op>
+    Acc parallel_scan(const T* in, Acc* out, size_t n, int threads, Acc init, Op op, bool inclusive) {
+        threads = thread_count(n, threads);
+        if (threads == 1)
+            return kernel<T, Acc, Op>::scan(in, out, n, init, op, inclusive);
+
+        // pass 1: chunk totals, scanned into the value each chunk starts from
+        std::vector<Acc> offset(threads + 1, init);
+        for_chunks(n, threads, [&](int t, size_t b, size_t e) {
+            if (t == 0)
+                offset[1] = kernel<T, Acc, Op>::reduce(in, e, init, op);
+            else
+                offset[t + 1] = kernel<T, Acc, Op>::reduce(in + b + 1, e - b - 1, static_cast<Acc>(in[b]), op);
+        });
+        for (int t = 2; t <= threads; ++t)
+            offset[t] = combine(op, offset[t - 1], offset[t]);
+
+        // pass 2: every chunk scanned from its offset
+        for_chunks(n, threads, [&](int t, size_t b, size_t e) {
+            kernel<T, Acc, Op>::scan(in + b, out + b, e - b, offset[t], op, inclusive);
+        });
+        return offset[threads];
+    }
+}
+
+template <class T, class Acc = wide_t<T>, class Op = std::plus<Acc>>
+Acc reduce_n(const T* data, size_t n, Acc init = Acc(), Op op = Op()) {
+    return scan_detail::kernel<T, Acc, Op>::reduce(data, n, init, op);
+}
+
+// Writes out[0..n) and returns the total
+template <class T, class Acc = wide_t<T>, class Op = std::plus<Acc>>
+Acc inclusive_scan_n(const T* in, Acc* out, size_t n, Acc init = Acc(), Op op = Op()) {
+    return scan_detail::kernel<T, Acc, Op>::scan(in, out, n, init, op, true);
+}
+
+template <class T, class Acc = wide_t<T>, class Op = std::plus<Acc>>
+Acc exclusive_scan_n(const T* in, Acc* out, size_t n, Acc init = Acc(), Op op = Op()) {
+    return scan_detail::kernel<T, Acc, Op>::scan(in, out, n, init, op, false);
+}
+
+// threads = 0: one per hardware thread
+template <class T, class Acc = wide_t<T>, class Op = std::plus<Acc>>
+Acc parallel_reduce_n(const T* data, size_t n, int threads = 0, Acc init = Acc(), Op op = Op()) {
+    if (n == 0)
+        return init;
+    threads = scan_detail::thread_count(n, threads);
+    std::vector<Acc> partial(threads);
+    scan_detail::for_chunks(n, threads, [&](int t, size_t b, size_t e) {
+        partial[t] = scan_detail::kernel<T, Acc, Op>::reduce(data + b + 1, e - b - 1, static_cast<Acc>(data[b]), op);
+    });
+    for (const Acc& p : partial)
+        init = scan_detail::combine(op, init, p);
+    return init;
+}
+
+template <class T, class Acc = wide_t<T>, class Op = std::plus<Acc>>
+Acc parallel_inclusive_scan_n(const T* in, Acc* out, size_t n, int threads = 0, Acc init = Acc(), Op op = Op()) {
+    return scan_detail::parallel_scan(in, out, n, threads, init, op, true);
+}
+
+template <class T, class Acc = wide_t<T>, class Op = std::plus<Acc>>
+Acc parallel_exclusive_scan_n(const T* in, Acc* out, size_t n, int threads = 0, Acc init = Acc(), Op op = Op()) {
+    return scan_detail::parallel_scan(in, out, n, threads, init, op, false);
+}
@@ -28,6 +28,7 @@ and implementing efficient algorithms with proper termination and loop condition
 #include <iostream>
 #include <list>
 #include <vector>
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
@@ -35,6 +36,11 @@ and implementing efficient algorithms with proper termination and loop condition
 #include <queue>
 #include <limits>
 #include <stack>
+#include <string>
+
+#include "../../Common/Fast_Random.h"
+#include "../../Common/Graph_Stats.h"
+#include "Shortest_Path_Cache.h"
 
 using namespace std;
 
@@ -45,6 +51,11 @@ private:
     vector<vector<double>> AdjacencyMatrix;   // Adjacency matrix representation
     double minWeight;                       // Minimum edge weight
     double maxWeight;                       // Maximum edge weight
+    mutable graph_stats last_stats;         // Counters of the last Dijkstra run (Graph_Stats.h)
+    mutable shortest_path_cache path_cache; // Trees of recent sources (Shortest_Path_Cache.h)
+
+    shortest_path_tree search(int i, int stop) const; // Dijkstra from i, until stop is settled (-1: all nodes)
+    const shortest_path_tree& tree_from(int i, int j, shortest_path_tree& local) const;
 
 public:
     // Default Constructor
@@ -59,15 +70,20 @@ public:
     }
 
     // Constructor given # of nodes, density, and min/max distance
-    Graph(int n, double density, double min, double max) 
+    // Draws from the thread's engine (Fast_Random.h), seeded once in main
+    Graph(int n, double density, double min, double max) : Graph(n, density, min, max, thread_rng()) {}
+
+    // Same, drawing from a caller-owned engine, e.g. Graph(n, 0.2, 1.0, 10.0, xoshiro256ss(seed))
+    // for a reproducible graph
+    template <class Engine>
+    Graph(int n, double density, double min, double max, Engine&& rng)
         : nodes(n), AdjacencyMatrix(n, vector<double>(n, 0.0)), minWeight(min), maxWeight(max) {
-        srand(time(0));                      // Set random seed
         for (int i = 0; i < n; ++i) {                // Iterate over each node starting point
             for (int j = i; j < n; ++j) {        // Iterate over each potential arrival node (undirected graph)
                 if (i != j) {      // Avoid self-loops
                     // Take into account given density, in order to get the right proportion of edges from each node
-                    if ((static_cast<double>(rand()) / RAND_MAX) < density) {
-                        double random_edge = (static_cast<double>(rand()) * (max - min)) / RAND_MAX + min; // Scale in [min, max]
+                    if (uniform_double(rng) < density) {
+                        double random_edge = uniform_double(rng, min, max); // Scale in [min, max)
                         double rounded_edge = round(random_edge * 10) / 10; // Round up number to one decimal
                         AdjacencyMatrix[i][j] = rounded_edge;   // i->j edge
                         AdjacencyMatrix[j][i] = rounded_edge;   // j->i edge (symmetric graph)
@@ -92,6 +108,10 @@ public:
     void set_edge_value(int x, int y, double v); // Set value of an edge
     void print() const; // Print the Graph
     void Dijkstra(int i, int j) const; // Algorithm Method
+    const graph_stats& stats() const { return last_stats; } // Counters of the last Dijkstra run, if compiled in
+    double distance(int i, int j) const; // Shortest path cost, infinity if there is no path
+    const shortest_path_cache& cache() const { return path_cache; } // Hit rate and memory use
+    void set_cache_budget(size_t bytes) { path_cache.set_budget(bytes); } // 0 turns the cache off
 };
 
 
@@ -152,11 +172,12 @@ void Graph::add(int x, int y) {
     }
     else {
         // Generate a random number within [minWeight, maxWeight] for the edge weight
-        average_edge = (static_cast<double>(rand()) * (maxWeight - minWeight)) / RAND_MAX + minWeight;
+        average_edge = uniform_double(thread_rng(), minWeight, maxWeight);
     }
     // Add the new edge
     AdjacencyMatrix[x][y] = average_edge;
     AdjacencyMatrix[y][x] = average_edge; // Ensure symmetry for an undirected graph
+    path_cache.edge_changed(x, y, 0.0, average_edge);
     cout << "An edge between " << x << " and " << y << " has been created. "
         << "Its weight is " << average_edge << " (calculated or randomly generated)." << endl;
 }
@@ -169,6 +190,7 @@ void Graph::removeEdge(int x, int y) {
         return;
     }
     else {
+        path_cache.edge_changed(x, y, AdjacencyMatrix[x][y], 0.0);
         AdjacencyMatrix[x][y] = 0.0;
         AdjacencyMatrix[y][x] = 0.0;
     }
@@ -181,6 +203,7 @@ double Graph::get_edge_value(int x, int y) const {
 
 // Set edge value between two nodes
 void Graph::set_edge_value(int x, int y, double v) {
+    path_cache.edge_changed(x, y, AdjacencyMatrix[x][y], v);
     AdjacencyMatrix[x][y] = v;
     AdjacencyMatrix[y][x] = v;
     cout << "Edge value between " << x << " and " << y << " set to " << v << "." << endl;
@@ -197,20 +220,21 @@ void Graph::print() const {
     }
 }
 
-void Graph::Dijkstra(int i, int j) const {
+// Dijkstra's algorithm from i, stopping once node 'stop' is settled (-1: settle every reachable node)
+shortest_path_tree Graph::search(int i, int stop) const {
     // Get the number of nodes in the adjacency matrix
     int n = AdjacencyMatrix.size();
 
-    // Validate the input node indices
-    if (i < 0 || j < 0 || i >= n || j >= n) {
-        cerr << "Invalid node indices." << endl;
-        return;
-    }
+    GRAPH_STAT(last_stats.reset("dijkstra", n));
+    GRAPH_STAT(graph_phase_clock clock);
 
+    shortest_path_tree tree;
     // Initialize distance vector with infinity for all nodes
-    vector<double> dist(n, numeric_limits<double>::infinity());
+    vector<double>& dist = tree.dist;
+    dist.assign(n, numeric_limits<double>::infinity());
     // Initialize the previous node vector to reconstruct paths
-    vector<int> previous(n, -1);
+    vector<int>& previous = tree.previous;
+    previous.assign(n, -1);
     // Set the distance to the source node as 0
     dist[i] = 0.0;
 
@@ -221,6 +245,8 @@ void Graph::Dijkstra(int i, int j) const {
 
     // Add the source node to the priority queue with a cost of 0
     pq.push({ 0.0, i });
+    GRAPH_STAT(last_stats.heap_pushes++);
+    GRAPH_STAT(clock.lap(last_stats.init_seconds));
 
     // Main loop: process nodes in the priority queue
     while (!pq.empty()) {
@@ -228,17 +254,27 @@ void Graph::Dijkstra(int i, int j) const {
         double current_cost = pq.top().first;
         int current_node = pq.top().second;
         pq.pop();
+        GRAPH_STAT(last_stats.heap_pops++);
+
+        // Skip entries left behind by a later improvement: the node was settled at a lower cost
+        if (current_cost > dist[current_node]) {
+            GRAPH_STAT(last_stats.stale_pops++);
+            continue;
+        }
+        GRAPH_STAT(last_stats.nodes_settled++);
 
         // If the destination node is reached, stop processing
-        if (current_node == j) break;
+        if (current_node == stop) break;
 
         // Explore all neighbors of the current node
         for (int neighbor = 0; neighbor < n; ++neighbor) {
             // Get the cost of the edge from the current node to the neighbor
             double edge_cost = AdjacencyMatrix[current_node][neighbor];
+            GRAPH_STAT(last_stats.edges_scanned++);
 
             // If the edge exists (cost > 0), calculate the potential new cost
             if (edge_cost > 0.0) {
+                GRAPH_STAT(last_stats.edges_found++);
                 double new_cost = current_cost + edge_cost;
 
                 // If the new cost is lower than the current known cost, update it
@@ -246,14 +282,60 @@ void Graph::Dijkstra(int i, int j) const {
                     dist[neighbor] = new_cost;          // Update the shortest distance to the neighbor
                     previous[neighbor] = current_node; // Update the previous node for path reconstruction
                     pq.push({ new_cost, neighbor });   // Add the neighbor to the priority queue
+                    GRAPH_STAT(last_stats.relaxations++);
+                    GRAPH_STAT(last_stats.heap_pushes++);
                 }
             }
         }
     }
+    GRAPH_STAT(clock.lap(last_stats.search_seconds));
+    return tree;
+}
+
+// Shortest path tree from i: from the cache, or searched and cached. With the cache off the search
+// stops at j, and the tree is returned in 'local'.
+const shortest_path_tree& Graph::tree_from(int i, int j, shortest_path_tree& local) const {
+    if (!path_cache.enabled()) {
+        local = search(i, j);
+        return local;
+    }
+    if (const shortest_path_tree* cached = path_cache.find(i)) {
+        GRAPH_STAT(last_stats.reset("dijkstra", nodes));   // nothing searched
+        return *cached;
+    }
+    local = search(i, -1);    // the whole tree, for later queries from i
+    if (const shortest_path_tree* stored = path_cache.insert(i, move(local)))
+        return *stored;
+    return local;             // larger than the whole budget
+}
+
+double Graph::distance(int i, int j) const {
+    if (i < 0 || j < 0 || i >= nodes || j >= nodes)
+        return numeric_limits<double>::infinity();
+    shortest_path_tree local;
+    return tree_from(i, j, local).dist[j];
+}
+
+void Graph::Dijkstra(int i, int j) const {
+    // Get the number of nodes in the adjacency matrix
+    int n = AdjacencyMatrix.size();
+
+    // Validate the input node indices
+    if (i < 0 || j < 0 || i >= n || j >= n) {
+        cerr << "Invalid node indices." << endl;
+        return;
+    }
+
+    shortest_path_tree local;
+    const shortest_path_tree& tree = tree_from(i, j, local);
+    const vector<double>& dist = tree.dist;
+    const vector<int>& previous = tree.previous;
+    GRAPH_STAT(graph_phase_clock clock);
 
     // If the destination node is still unreachable, print a message and return
     if (dist[j] == numeric_limits<double>::infinity()) {
         cout << "No path exists from " << i << " to " << j << "." << endl;
+        GRAPH_STAT(clock.lap(last_stats.output_seconds));
         return;
     }
 
@@ -273,14 +355,104 @@ void Graph::Dijkstra(int i, int j) const {
         path.pop();
     }
     cout << endl;
+    GRAPH_STAT(clock.lap(last_stats.output_seconds));
 }
 
 
 
 
 
-int main()
+// Usage: DjikstraAlgorithm stats [nodes]
+// One search from node 0 to the last node on graphs of increasing density, with the counters of
+// each as one line of JSON. Needs a build with GRAPH_STATS=1.
+int run_stats(int argc, char* argv[]) {
+    if (!graph_stats::enabled) {
+        cerr << "Statistics are not compiled in: build with GRAPH_STATS defined to 1." << endl;
+        return 1;
+    }
+    int n = argc > 2 ? atoi(argv[2]) : 1000;
+    if (n < 2) {
+        cerr << "Need at least 2 nodes." << endl;
+        return 1;
+    }
+    const double densities[] = { 0.005, 0.02, 0.1, 0.4, 1.0 };
+    for (double density : densities) {
+        Graph g(n, density, 1.0, 10.0, xoshiro256ss(n));
+        g.set_cache_budget(0);  // a cache miss searches the whole graph; count the search that stops at n - 1
+        g.Dijkstra(0, n - 1);
+        cout << "density " << density << ": ";
+        g.stats().write_json(cout);
+        cout << endl;
+    }
+    return 0;
+}
+
+// Usage: DjikstraAlgorithm cache [nodes] [queries] [budget MB] [edits]
+// Shortest path queries whose sources are mostly a few busy nodes, with some edge weights changed
+// along the way, answered without and with the cache; both must give the same costs.
+int run_cache(int argc, char* argv[]) {
+    int n = argc > 2 ? atoi(argv[2]) : 1000;
+    int queries = argc > 3 ? atoi(argv[3]) : 5000;
+    double budget_mb = argc > 4 ? atof(argv[4]) : 16.0;
+    int edits = argc > 5 ? atoi(argv[5]) : 10;
+    if (n < 2 || queries < 1) {
+        cerr << "Need at least 2 nodes and 1 query." << endl;
+        return 1;
+    }
+
+    // 9 queries in 10 start from one of 32 busy sources
+    xoshiro256ss rng(2024);
+    vector<int> busy(32);
+    for (int& b : busy)
+        b = uniform_int(rng, 0, n - 1);
+    vector<pair<int, int>> pairs(queries);
+    for (auto& q : pairs) {
+        q.first = uniform_double(rng) < 0.9 ? busy[uniform_int(rng, 0, 31)] : uniform_int(rng, 0, n - 1);
+        q.second = uniform_int(rng, 0, n - 1);
+    }
+    const int every = edits > 0 ? max(1, queries / edits) : queries + 1;
+
+    Graph base(n, 0.05, 1.0, 10.0, xoshiro256ss(n));
+    vector<double> costs[2];
+    for (int run = 0; run < 2; ++run) {
+        Graph g(base);
+        g.set_cache_budget(run ? static_cast<size_t>(budget_mb * 1e6) : 0);
+        xoshiro256ss edit_rng(7);   // the same edits in both runs
+        double seconds = 0.0;       // the queries only: set_edge_value prints a line
+        auto t0 = chrono::steady_clock::now();
+        for (int q = 0; q < queries; ++q) {
+            if (q % every == every / 2) {
+                int x = uniform_int(edit_rng, 0, n - 1), y = uniform_int(edit_rng, 0, n - 1);
+                double v = round(uniform_double(edit_rng, 1.0, 10.0) * 10) / 10;
+                seconds += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+                g.set_edge_value(x, y, v);
+                t0 = chrono::steady_clock::now();
+            }
+            costs[run].push_back(g.distance(pairs[q].first, pairs[q].second));
+        }
+        seconds += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        const shortest_path_cache& c = g.cache();
+        cout << (run ? "cache on:  " : "cache off: ") << queries / seconds << " queries/s";
+        if (run)
+            cout << ", hit rate " << c.hit_rate() << ", " << c.size() << " trees in " << c.memory_used() / 1e6
+                << " of " << c.memory_budget() / 1e6 << " MB, " << c.evictions() << " evictions, "
+                << c.invalidations() << " invalidated by edits";
+        cout << endl;
+    }
+    if (costs[0] != costs[1])
+        cout << "Cached and searched costs differ!" << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && string(argv[1]) == "stats")
+        return run_stats(argc, argv);
+    if (argc > 1 && string(argv[1]) == "cache")
+        return run_cache(argc, argv);
+
+    seed_thread_rngs(static_cast<uint64_t>(time(0)));  // Set random seed once for all graphs
 
     Graph g1(50, 0.4, 1.0, 10.0);
     cout << "Graph 1:" << endl;
@@ -291,6 +463,10 @@ int main()
     int destination = 35; // Destination node
     cout << "\nRunning Dijkstra's Algorithm on Graph 1 from node " << source << " to node " << destination << ":\n";
     g1.Dijkstra(source, destination);
+    if (graph_stats::enabled) {
+        g1.stats().write_json(cout);
+        cout << endl;
+    }
 
 
     Graph g2(50, 0.2, 1.0, 10.0);
@@ -302,6 +478,10 @@ int main()
     int destination_2 = 43; // Destination node
     cout << "\nRunning Dijkstra's Algorithm on Graph 2 from node " << source_2 << " to node " << destination_2 << ":\n";
     g2.Dijkstra(source_2, destination_2);
+    if (graph_stats::enabled) {
+        g2.stats().write_json(cout);
+        cout << endl;
+    }
 
     // Testing all the other methods of the Graph class
 
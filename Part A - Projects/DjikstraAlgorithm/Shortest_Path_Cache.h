@@ -0,0 +1,149 @@
+// Shortest_Path_Cache.h : Bounded LRU cache of single-source shortest path trees.
+//
+/*
+Dijkstra's algorithm from a source computes the distances to every node it settles. When the same
+sources come back again and again, the whole tree (distance and predecessor of every node) can be
+kept, and any later query from that source is answered by walking the predecessors, without a
+search.
+
+shortest_path_cache keeps such trees keyed by source, the most recently used first. It is bounded
+by a memory budget in bytes: a tree of V nodes takes 12 * V bytes plus a little bookkeeping, and
+the least recently used trees are dropped until a new one fits. A budget of 0 turns the cache off.
+A miss searches the whole graph instead of stopping at the destination, so it costs more than an
+uncached query; when sources rarely repeat, turn the cache off.
+
+When an edge x - y changes weight (added, removed, set), a tree stays valid when
+- it does not use the edge (neither node is the predecessor of the other in it), or uses it with
+  the same weight, and
+- the new weight does not give a shorter path through the edge:
+  dist[x] + w >= dist[y] and dist[y] + w >= dist[x].
+Trees that fail the test are dropped; the others are still exact, so edits far from the busy
+part of the graph cost nothing.
+
+The cache is not thread-safe; a Graph shared between threads needs its own lock around queries.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Distances from one source, and the node before each one on its shortest path (-1: none)
+struct shortest_path_tree {
+    std::vector<double> dist;
+    std::vector<int> previous;
+
+    size_t bytes() const { return dist.capacity() * sizeof(double) + previous.capacity() * sizeof(int); }
+};
+
+class shortest_path_cache {
+public:
+    explicit shortest_path_cache(size_t budget_bytes = 16 << 20) : budget(budget_bytes), used(0),
+        hit_count(0), miss_count(0), evicted(0), invalidated(0) {}
+
+    bool enabled() const { return budget > 0; }
+
+    // The tree from source, marked most recently used; nullptr if it is not cached
+    const shortest_path_tree* find(int source) {
+        auto it = index.find(source);
+        if (it == index.end()) {
+            miss_count++;
+            return nullptr;
+        }
+        hit_count++;
+        lru.splice(lru.begin(), lru, it->second);
+        return &it->second->tree;
+    }
+
+    // Stores the tree from source (moved from), evicting the least recently used trees to make
+    // room. Returns the stored tree, or nullptr and leaves 'tree' as it was if it does not fit in
+    // the whole budget.
+    const shortest_path_tree* insert(int source, shortest_path_tree&& tree) {
+        const size_t size = entry_bytes(tree);
+        if (size > budget)
+            return nullptr;
+        erase(source);
+        while (used + size > budget) {
+            erase(lru.back().source);
+            evicted++;
+        }
+        lru.push_front(entry{ source, std::move(tree), size });
+        index[source] = lru.begin();
+        used += size;
+        return &lru.front().tree;
+    }
+
+    // Edge x - y changed from weight 'before' to 'after' (0: no edge): drops the trees it affects
+    void edge_changed(int x, int y, double before, double after) {
+        for (auto it = lru.begin(); it != lru.end();) {
+            const shortest_path_tree& t = it->tree;
+            bool in_tree = t.previous[y] == x || t.previous[x] == y;
+            bool stale = (in_tree && after != before) ||
+                (after > 0.0 && (t.dist[x] + after < t.dist[y] || t.dist[y] + after < t.dist[x]));
+            auto next = std::next(it);
+            if (stale) {
+                erase(it->source);
+                invalidated++;
+            }
+            it = next;
+        }
+    }
+
+    void clear() {
+        lru.clear();
+        index.clear();
+        used = 0;
+    }
+
+    // New budget in bytes, evicting as needed; 0 empties the cache and turns it off
+    void set_budget(size_t bytes) {
+        budget = bytes;
+        while (used > budget) {
+            erase(lru.back().source);
+            evicted++;
+        }
+    }
+
+    size_t size() const { return lru.size(); }
+    size_t memory_used() const { return used; }
+    size_t memory_budget() const { return budget; }
+    uint64_t hits() const { return hit_count; }
+    uint64_t misses() const { return miss_count; }
+    uint64_t evictions() const { return evicted; }
+    uint64_t invalidations() const { return invalidated; }
+    double hit_rate() const { return hit_count + miss_count ? double(hit_count) / (hit_count + miss_count) : 0.0; }
+
+private:
+    struct entry {
+        int source;
+        shortest_path_tree tree;
+        size_t bytes;
+    };
+
+    std::list<entry> lru;   // most recently used first
+    std::unordered_map<int, std::list<entry>::iterator> index;
+    size_t budget;
+    size_t used;
+    uint64_t hit_count;
+    uint64_t miss_count;
+    uint64_t evicted;
+    uint64_t invalidated;
+
+    // The tree, its list node and its index node (key, iterator and two pointers)
+    static size_t entry_bytes(const shortest_path_tree& tree) {
+        return tree.bytes() + sizeof(entry) + 2 * sizeof(void*) + sizeof(int) + 3 * sizeof(void*);
+    }
+
+    void erase(int source) {
+        auto it = index.find(source);
+        if (it == index.end())
+            return;
+        used -= it->second->bytes;
+        lru.erase(it->second);
+        index.erase(it);
+    }
+};
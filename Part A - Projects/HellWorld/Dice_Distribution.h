@@ -0,0 +1,203 @@
+//Dice_Distribution.h : distribution of the sum of n dice with any number of sides,
+//exactly by convolution or estimated by multi-threaded Monte Carlo.
+/*
+Exact: the distribution of one die is p[1..sides] = 1/sides, and the distribution of a sum of
+independent dice is the convolution of theirs. The n-fold convolution is built by repeated
+squaring (log2(n) squarings plus one multiply per set bit of n). Each convolution is done
+directly while it is cheap and with an FFT once both operands are long (O(m log m) instead of
+O(a * b)), which is what makes hundreds of dice with many sides instant. FFT results carry a
+rounding error around 1e-16 in every entry, so tail probabilities below that are not
+meaningful in FFT mode; they are clamped at zero.
+
+Monte Carlo: trials are split in contiguous blocks over the threads and every thread fills its
+own histogram, merged once at the end. Random numbers come from the counter-based Philox4x32
+generator of Fast_Random.h, with one stream per fixed chunk of 4096 trials: the numbers of a
+trial are a pure function of (seed, trial), so the result does not depend on the number of
+threads, and no generator state has to be handed from thread to thread.
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../../Common/Fast_Random.h"
+
+//direct convolution up to this many multiply-adds, FFT above
+const double DIRECT_CONVOLUTION_LIMIT = 1 << 16;
+
+//in-place iterative radix-2 FFT; size must be a power of two
+inline void fft(std::vector<std::complex<double>>& a, bool inverse)
+{
+	const size_t n = a.size();
+	const double pi = std::acos(-1.0);
+	for (size_t i = 1, j = 0; i < n; ++i) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if (i < j)
+			std::swap(a[i], a[j]);
+	}
+	for (size_t len = 2; len <= n; len <<= 1) {
+		double angle = 2 * pi / len * (inverse ? -1 : 1);
+		std::complex<double> wlen(std::cos(angle), std::sin(angle));
+		for (size_t i = 0; i < n; i += len) {
+			std::complex<double> w(1);
+			for (size_t j = 0; j < len / 2; ++j) {
+				std::complex<double> u = a[i + j], v = a[i + j + len / 2] * w;
+				a[i + j] = u + v;
+				a[i + j + len / 2] = u - v;
+				w *= wlen;
+			}
+		}
+	}
+	if (inverse)
+		for (auto& x : a)
+			x /= static_cast<double>(n);
+}
+
+//c[k] = sum of a[i] * b[k - i]
+inline std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b)
+{
+	if (a.empty() || b.empty())
+		return std::vector<double>();
+	std::vector<double> c(a.size() + b.size() - 1, 0.0);
+	if (static_cast<double>(a.size()) * b.size() <= DIRECT_CONVOLUTION_LIMIT) {
+		for (size_t i = 0; i < a.size(); ++i)
+			for (size_t j = 0; j < b.size(); ++j)
+				c[i + j] += a[i] * b[j];
+		return c;
+	}
+
+	size_t n = 1;
+	while (n < c.size())
+		n <<= 1;
+	//one complex FFT carries both real inputs: a in the real part, b in the imaginary part
+	std::vector<std::complex<double>> f(n);
+	for (size_t i = 0; i < a.size(); ++i)
+		f[i].real(a[i]);
+	for (size_t i = 0; i < b.size(); ++i)
+		f[i].imag(b[i]);
+	fft(f, false);
+	//with F = FFT(a + ib): A[k] = (F[k] + conj F[n-k]) / 2 and B[k] = (F[k] - conj F[n-k]) / 2i,
+	//so A[k] * B[k] = (F[k]^2 - (conj F[n-k])^2) / 4i and a single inverse FFT gives c
+	std::vector<std::complex<double>> g(n);
+	for (size_t k = 0; k < n; ++k) {
+		std::complex<double> x = f[k], y = std::conj(f[(n - k) & (n - 1)]);
+		g[k] = (x * x - y * y) / std::complex<double>(0, 4);
+	}
+	fft(g, true);
+	for (size_t i = 0; i < c.size(); ++i)
+		c[i] = std::max(0.0, g[i].real());
+	return c;
+}
+
+//Exact distribution of the sum of n_dice dice numbered 1..sides: p[s] for s = 0..n_dice * sides
+inline std::vector<double> exact_distribution(int n_dice, int sides)
+{
+	std::vector<double> result(1, 1.0);                  //sum of no dice: always 0
+	std::vector<double> power(sides + 1, 1.0 / sides);   //one die
+	power[0] = 0.0;
+	for (int n = n_dice; n > 0; n >>= 1) {
+		if (n & 1)
+			result = convolve(result, power);
+		if (n > 1)
+			power = convolve(power, power);
+	}
+	return result;
+}
+
+//Unbiased roll in 1..sides (Lemire's multiply-and-reject). Dice with up to 256 sides take 16 bits
+//per roll, so one 64-bit draw of the engine gives four rolls; larger dice take 32 bits.
+template <class Engine>
+class dice_roller {
+public:
+	explicit dice_roller(Engine& r) : rng(r), buffer(0), left(0) {}
+
+	int roll(uint32_t sides)
+	{
+		const int bits = sides <= 256 ? 16 : 32;
+		uint64_t m = next(bits) * sides;
+		if ((m & mask(bits)) < sides) {
+			uint64_t threshold = (mask(bits) + 1 - sides) % sides;
+			while ((m & mask(bits)) < threshold)
+				m = next(bits) * sides;
+		}
+		return static_cast<int>(m >> bits) + 1;
+	}
+
+private:
+	Engine& rng;
+	uint64_t buffer;
+	int left;	//unused bits in buffer
+
+	static uint64_t mask(int bits) { return (1ULL << bits) - 1; }
+
+	uint64_t next(int bits)
+	{
+		if (left < bits) {
+			buffer = random_bits64(rng);
+			left = 64;
+		}
+		uint64_t x = buffer & mask(bits);
+		buffer >>= bits;
+		left -= bits;
+		return x;
+	}
+};
+
+struct dice_simulation {
+	std::vector<uint64_t> histogram;   //histogram[s] = trials with sum s
+	uint64_t trials = 0;
+	int threads = 0;
+	double seconds = 0.0;
+
+	double rolls_per_second(int n_dice) const { return seconds > 0.0 ? trials * static_cast<double>(n_dice) / seconds : 0.0; }
+};
+
+inline dice_simulation simulate_dice(int n_dice, int sides, uint64_t trials, int threads = 0, uint64_t seed = 1)
+{
+	dice_simulation sim;
+	sim.threads = threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	sim.trials = trials;
+	const size_t bins = static_cast<size_t>(n_dice) * sides + 1;
+	std::vector<std::vector<uint64_t>> partial(sim.threads, std::vector<uint64_t>(bins, 0));
+
+	//trials are grouped in fixed chunks and chunk c draws from Philox stream c, so every trial
+	//sees the same numbers whatever the number of threads
+	const uint64_t CHUNK = 4096;
+	const uint64_t chunks = (trials + CHUNK - 1) / CHUNK;
+	auto worker = [&](int t) {
+		std::vector<uint64_t>& hist = partial[t];
+		for (uint64_t c = chunks * t / sim.threads; c < chunks * (t + 1) / sim.threads; ++c) {
+			philox4x32 rng(seed, c);
+			dice_roller<philox4x32> dice(rng);
+			for (uint64_t trial = c * CHUNK; trial < std::min(trials, (c + 1) * CHUNK); ++trial) {
+				int roll = 0;
+				for (int k = 0; k < n_dice; ++k)
+					roll += dice.roll(sides);
+				hist[roll]++;
+			}
+		}
+	};
+
+	auto t0 = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (int t = 1; t < sim.threads; ++t)
+		pool.emplace_back(worker, t);
+	worker(0);
+	for (auto& th : pool)
+		th.join();
+	sim.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+	sim.histogram.assign(bins, 0);
+	for (const auto& h : partial)
+		for (size_t s = 0; s < bins; ++s)
+			sim.histogram[s] += h[s];
+	return sim;
+}
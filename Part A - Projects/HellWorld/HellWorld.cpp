@@ -1,23 +1,158 @@
 //The following program computes
 //the probability for dice possibilities
 #include <iostream>
+#include <iomanip>
 #include <random>
 #include <ctime>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Dice_Distribution.h"
 using namespace std;
 const int sides = 6;
-int main(void)
+
+//print p[s] for every sum that is possible, and the mean and variance as a check
+//against n * (sides + 1) / 2 and n * (sides^2 - 1) / 12
+void print_distribution(const vector<double>& p, int n_dice, int n_sides)
 {
+	double mean = 0, second = 0;
+	for (int j = n_dice; j < static_cast<int>(p.size()); ++j) {
+		cout << "j = " << j << " p = " << p[j] << endl;
+		mean += j * p[j];
+		second += static_cast<double>(j) * j * p[j];
+	}
+	cout << "mean = " << mean << " (expected " << n_dice * (n_sides + 1) / 2.0 << "), variance = "
+		<< second - mean * mean << " (expected " << n_dice * (static_cast<double>(n_sides) * n_sides - 1) / 12.0 << ")" << endl;
+}
+
+//exact <n_dice> <sides>
+int run_exact(int argc, char* argv[])
+{
+	int n_dice = argc > 2 ? atoi(argv[2]) : 2;
+	int n_sides = argc > 3 ? atoi(argv[3]) : sides;
+	if (n_dice < 1 || n_sides < 1) {
+		cerr << "Need at least one die with at least one side." << endl;
+		return 1;
+	}
+	auto t0 = chrono::steady_clock::now();
+	vector<double> p = exact_distribution(n_dice, n_sides);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+	cout << "exact distribution of " << n_dice << " dice with " << n_sides << " sides ("
+		<< seconds * 1000 << " ms)\n";
+	print_distribution(p, n_dice, n_sides);
+	return 0;
+}
+
+//montecarlo <n_dice> <sides> <trials> [threads] [seed]
+int run_monte_carlo(int argc, char* argv[])
+{
+	int n_dice = argc > 2 ? atoi(argv[2]) : 2;
+	int n_sides = argc > 3 ? atoi(argv[3]) : sides;
+	uint64_t trials = argc > 4 ? stoull(argv[4]) : 1000000;
+	int threads = argc > 5 ? atoi(argv[5]) : 0;
+	uint64_t seed = argc > 6 ? stoull(argv[6]) : 1;
+	if (n_dice < 1 || n_sides < 1 || trials == 0) {
+		cerr << "Need at least one die with at least one side and one trial." << endl;
+		return 1;
+	}
+
+	dice_simulation sim = simulate_dice(n_dice, n_sides, trials, threads, seed);
+	vector<double> exact = exact_distribution(n_dice, n_sides);
+	vector<double> p(sim.histogram.size());
+	double worst = 0;
+	for (size_t j = 0; j < p.size(); ++j) {
+		p[j] = static_cast<double>(sim.histogram[j]) / trials;
+		worst = max(worst, abs(p[j] - exact[j]));
+	}
+	cout << trials << " trials of " << n_dice << " dice with " << n_sides << " sides on " << sim.threads
+		<< " threads in " << sim.seconds << "s (" << sim.rolls_per_second(n_dice) / 1e6 << " M rolls/s)\n";
+	print_distribution(p, n_dice, n_sides);
+	cout << "largest difference from the exact distribution: " << worst << endl;
+	return 0;
+}
+
+//draws per second of every engine: raw 64-bit words, rolls of a die and doubles in [0, 1),
+//each thread drawing from its own stream
+template <class Engine, class MakeEngine>
+void bench_engine(const char* name, MakeEngine make, uint64_t draws, int threads)
+{
+	auto timed = [&](auto draw) {
+		vector<uint64_t> sink(threads);
+		vector<thread> pool;
+		auto t0 = chrono::steady_clock::now();
+		for (int t = 0; t < threads; ++t)
+			pool.emplace_back([&, t]() {
+				Engine rng = make(t);
+				uint64_t acc = 0;
+				for (uint64_t i = 0; i < draws; ++i)
+					acc += draw(rng);
+				sink[t] = acc;
+			});
+		for (auto& th : pool)
+			th.join();
+		double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+		uint64_t total = 0;
+		for (uint64_t x : sink)
+			total += x;
+		cout << setw(12) << draws * threads / seconds / 1e6 << (total == 1 ? " " : "");   //total keeps the loop alive
+	};
+	cout << left << setw(14) << name << right << fixed << setprecision(1);
+	timed([](Engine& rng) { return random_bits64(rng); });
+	timed([](Engine& rng) { return static_cast<uint64_t>(bounded_rand(rng, 6)); });
+	timed([](Engine& rng) { return static_cast<uint64_t>(uniform_double(rng) * 1e6); });
+	cout << endl;
+}
+
+//rngbench [draws per thread] [threads]
+int run_rng_benchmark(int argc, char* argv[])
+{
+	uint64_t draws = argc > 2 ? stoull(argv[2]) : 50000000;
+	int threads = argc > 3 ? atoi(argv[3]) : 1;
+	if (threads < 1)
+		threads = 1;
+	cout << "M draws/s, " << threads << " thread(s), " << draws << " draws each\n";
+	cout << left << setw(14) << "engine" << right << setw(12) << "64-bit" << setw(12) << "die roll" << setw(12) << "double" << endl;
+
+	uint64_t seed = 12345;
+	bench_engine<xoshiro256ss>("xoshiro256**", [&](int t) { return xoshiro256ss::stream(seed, t); }, draws, threads);
+	bench_engine<pcg32>("pcg32", [&](int t) { return pcg32(seed, t); }, draws, threads);
+	bench_engine<philox4x32>("philox4x32", [&](int t) { return philox4x32(seed, t); }, draws, threads);
+	bench_engine<splitmix64>("splitmix64", [&](int t) { return splitmix64(seed + (static_cast<uint64_t>(t) << 40)); }, draws, threads);
+	bench_engine<mt19937_64>("mt19937_64", [&](int t) { return mt19937_64(seed + t); }, draws, threads);
+	bench_engine<mt19937>("mt19937", [&](int t) { return mt19937(static_cast<unsigned>(seed + t)); }, draws, threads);
+
+	//rand() for reference: shared state, only RAND_MAX + 1 values, and 'rand() % 6' is biased
+	auto t0 = chrono::steady_clock::now();
+	uint64_t acc = 0;
+	for (uint64_t i = 0; i < draws; ++i)
+		acc += rand() % 6;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+	cout << left << setw(14) << "rand() % 6" << right << setw(12) << "-" << setw(12) << draws / seconds / 1e6
+		<< setw(12) << "-" << (acc == 1 ? " " : "") << "  (1 thread)" << endl;
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && string(argv[1]) == "exact")
+		return run_exact(argc, argv);
+	if (argc > 1 && string(argv[1]) == "montecarlo")
+		return run_monte_carlo(argc, argv);
+	if (argc > 1 && string(argv[1]) == "rngbench")
+		return run_rng_benchmark(argc, argv);
+
 	const int n_dice = 2;
-	uniform_int_distribution<unsigned> u(1, 6);
-	default_random_engine e(static_cast<unsigned int>(time(0)));
+	seed_thread_rngs(static_cast<uint64_t>(time(0)));
+	xoshiro256ss& e = thread_rng();	// the shared fast engine (Fast_Random.h)
 	cout << "\nEnter number of trials: ";
 	int trials;
 	cin >> trials; //compare to scanf
-	int* outcomes = new int[n_dice * sides + 1]();
+	vector<int> outcomes(n_dice * sides + 1, 0);
 	for (int j = 0; j < trials; ++j) {
 		int roll = 0;
 		for (int k = 1; k <= n_dice; ++k) {
-			roll += u(e);
+			roll += static_cast<int>(uniform_int(e, 1, sides));
 		}
 		outcomes[roll]++;
 	}
@@ -27,4 +162,4 @@ int main(void)
 			<< static_cast<double>(outcomes[j]) / trials
 			<< endl;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,194 @@
+// Concurrent_List.h : Lock-free list for many producers prepending and one consumer detaching.
+//
+/*
+prepend() is the list prepend turned into a compare-and-swap loop on head (a Treiber push):
+the new node points at the head it saw and is published only if head has not moved since.
+detach() swaps head with null and hands the whole chain over as a batch, so producers never
+wait for the consumer and the consumer never waits for producers.
+
+Memory reclamation is epoch based. Readers walking the live list with for_each() pin the current
+epoch for the duration of the walk. A detached batch is not deleted when the consumer drops it
+but retired with the epoch of that moment, and freed once the global epoch has moved two steps
+further, which needs every pinned reader to have caught up: nobody can still be looking at it.
+Pushing and detaching never dereference a node of someone else, so they need no pinning.
+
+Retiring and reclaiming take a mutex; they run once per batch, not once per element.
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class concurrent_list {
+    struct node {
+        int d;
+        node* next;
+
+        node(int val, node* n) : d(val), next(n) {}
+    };
+
+public:
+    static const int MAX_READERS = 128; // readers that can be pinned at the same time
+
+    // The elements detached at once, newest first; owned by the consumer
+    class batch {
+    public:
+        batch(batch&& b) : owner(b.owner), head(b.head) { b.head = nullptr; }
+        batch(const batch&) = delete;
+        batch& operator=(const batch&) = delete;
+        ~batch() {
+            if (head)
+                owner->retire(head);
+        }
+
+        bool empty() const { return head == nullptr; }
+
+        size_t size() const {
+            size_t n = 0;
+            for (const node* e = head; e; e = e->next)
+                ++n;
+            return n;
+        }
+
+        template <class F>
+        void for_each(F f) const {
+            for (const node* e = head; e; e = e->next)
+                f(e->d);
+        }
+
+    private:
+        friend class concurrent_list;
+        batch(concurrent_list* o, node* h) : owner(o), head(h) {}
+
+        concurrent_list* owner;
+        node* head;
+    };
+
+    concurrent_list() : head(nullptr), global_epoch(0) {
+        for (auto& r : readers) {
+            r.epoch.store(IDLE);
+            r.used.store(false);
+        }
+    }
+
+    concurrent_list(const concurrent_list&) = delete;
+    concurrent_list& operator=(const concurrent_list&) = delete;
+
+    // Nobody may use the list any more: free the live nodes and everything still retired
+    ~concurrent_list() {
+        free_chain(head.load());
+        for (auto& r : retired)
+            free_chain(r.second);
+    }
+
+    // Lock-free: retry until head did not change between reading it and publishing n
+    void prepend(int n) {
+        node* e = new node(n, head.load(std::memory_order_relaxed));
+        while (!head.compare_exchange_weak(e->next, e, std::memory_order_release, std::memory_order_relaxed))
+            ;
+    }
+
+    // Take every element pushed so far in one atomic step. seq_cst, like the reader's pin and head
+    // load: otherwise retire() could still see a reader idle that already read the old head.
+    batch detach() { return batch(this, head.exchange(nullptr)); }
+
+    bool empty() const { return head.load() == nullptr; }
+
+    // Walk the live list while producers and the consumer keep going
+    template <class F>
+    void for_each(F f) {
+        epoch_guard pin(*this);
+        // seq_cst as the pin: a weaker load may be ordered before the pin is visible to retire()
+        for (const node* e = head.load(); e; e = e->next)
+            f(e->d);
+    }
+
+    // Batches retired but not yet freed
+    size_t pending_reclaim() {
+        std::lock_guard<std::mutex> lock(retire_mutex);
+        return retired.size();
+    }
+
+private:
+    static const uint64_t IDLE = ~0ULL;
+
+    struct alignas(64) reader_slot {
+        std::atomic<uint64_t> epoch; // epoch pinned by the reader, IDLE when not reading
+        std::atomic<bool> used;
+    };
+
+    // Pins the global epoch in a free reader slot for as long as it lives
+    class epoch_guard {
+    public:
+        explicit epoch_guard(concurrent_list& l) : slot(nullptr) {
+            size_t start = std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_READERS;
+            for (size_t i = start;; i = (i + 1) % MAX_READERS) {
+                bool expected = false;
+                if (!l.readers[i].used.load(std::memory_order_relaxed) &&
+                    l.readers[i].used.compare_exchange_strong(expected, true)) {
+                    slot = &l.readers[i];
+                    break;
+                }
+            }
+            slot->epoch.store(l.global_epoch.load());   // seq_cst, ordered before the seq_cst head load
+        }
+        ~epoch_guard() {
+            slot->epoch.store(IDLE);
+            slot->used.store(false, std::memory_order_release);
+        }
+
+    private:
+        reader_slot* slot;
+    };
+
+    std::atomic<node*> head;
+    std::atomic<uint64_t> global_epoch;
+    reader_slot readers[MAX_READERS];
+    std::mutex retire_mutex;
+    std::vector<std::pair<uint64_t, node*>> retired; // (epoch when retired, detached chain)
+
+    static void free_chain(node* e) {
+        while (e) {
+            node* next = e->next;
+            delete e;
+            e = next;
+        }
+    }
+
+    void retire(node* chain) {
+        std::vector<node*> done;
+        {
+            std::lock_guard<std::mutex> lock(retire_mutex);
+            retired.emplace_back(global_epoch.load(), chain);
+
+            // The epoch can move on once every pinned reader has seen the current one
+            uint64_t e = global_epoch.load();
+            bool advance = true;
+            for (auto& r : readers) {
+                uint64_t pinned = r.epoch.load();
+                if (pinned != IDLE && pinned != e)
+                    advance = false;
+            }
+            if (advance)
+                global_epoch.store(++e);
+
+            // Readers that could hold a node retired at epoch r are pinned at r at most
+            size_t kept = 0;
+            for (auto& r : retired) {
+                if (r.first + 2 <= e)
+                    done.push_back(r.second);
+                else
+                    retired[kept++] = r;
+            }
+            retired.resize(kept);
+        }
+        for (node* c : done)
+            free_chain(c);
+    }
+};
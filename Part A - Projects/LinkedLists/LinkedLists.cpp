@@ -1,4 +1,21 @@
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <forward_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Concurrent_List.h"
+#include "List_Pool.h"
+#include "Unrolled_List.h"
 using namespace std;
 
 // Define the list_element class (node of the linked list)
@@ -11,65 +28,186 @@ public:
     list_element(int val, list_element* n = nullptr) : d(val), next(n) {}
 };
 
+// Forward iterator over the elements of a list; Value is int or const int
+template <class Value>
+class list_iterator {
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef int value_type;
+    typedef ptrdiff_t difference_type;
+    typedef Value* pointer;
+    typedef Value& reference;
+
+    list_iterator(list_element* e = 0) : e(e) {}
+    operator list_iterator<const int>() const { return list_iterator<const int>(e); } // iterator -> const_iterator
+
+    reference operator*() const { return e->d; }
+    pointer operator->() const { return &e->d; }
+    list_iterator& operator++() { e = e->next; return *this; }
+    list_iterator operator++(int) { list_iterator old = *this; e = e->next; return old; }
+    bool operator==(const list_iterator& other) const { return e == other.e; }
+    bool operator!=(const list_iterator& other) const { return e != other.e; }
+
+private:
+    list_element* e; // Current element, null at the end
+};
+
 // Define the list class
 class list {
 public:
-    list() : head(0), cursor(0) {} // Constructor initializes head and cursor to null
+    typedef list_iterator<int> iterator;
+    typedef list_iterator<const int> const_iterator;
+
+    list() : head(0), cursor(0), tail(0), pool(make_shared<node_pool<list_element>>()) {} // Constructor initializes head and cursor to null
+
+    // Constructor for a list drawing its nodes from a pool shared with other lists
+    explicit list(shared_ptr<node_pool<list_element>> shared) : head(0), cursor(0), tail(0), pool(shared) {}
 
     // Deep copy constructor
-    list(const list& lst) {
+    list(const list& lst) : tail(0), pool(make_shared<node_pool<list_element>>()) {
         // Check if the source list is empty
         if (lst.head == 0) {
             head = 0;   // Set head to null
             cursor = 0; // Set cursor to null
         }
         else {
+            // Reserve room for all the nodes: one allocation for the whole copy
+            size_t n = 0;
+            for (list_element* e = lst.head; e != 0; e = e->next)
+                ++n;
+            pool->reserve(n);
+
             // Set up the new list by copying elements from the source list
-            cursor = lst.head; // Start at the head of the source list
+            list_element* from = lst.head; // Start at the head of the source list
 
             // Create a new node for the head of the copied list
-            list_element* h = new list_element(cursor->d);
+            list_element* h = pool->create(from->d);
             list_element* previous; // Pointer to keep track of the previous node
             head = h; // Set the head of the new list
             previous = h; // Update the previous pointer
 
             // Traverse the source list and copy its elements
-            for (cursor = lst.head->next; cursor != 0; cursor = cursor->next) {
-                h = new list_element(cursor->d); // Create a new node for the current element
+            for (from = lst.head->next; from != 0; from = from->next) {
+                h = pool->create(from->d); // Create a new node for the current element
                 previous->next = h; // Link the previous node to the current node
                 previous = h; // Move the previous pointer forward
             }
             previous->next = 0; // Set the next pointer of the last node to null
+            tail = previous; // The last node copied is the tail
             cursor = head; // Set the cursor back to the head of the copied list
         }
     }
 
-    // Destructor to free dynamically allocated memory
+    // Move constructor: takes over the nodes and their pools in O(1), lst is left empty
+    list(list&& lst) : head(lst.head), cursor(lst.cursor), tail(lst.tail), pool(move(lst.pool)), adopted(move(lst.adopted)) {
+        lst.head = lst.cursor = lst.tail = 0;
+        lst.adopted.clear();
+    }
+
+    // Copy assignment: copy first, then swap, so a = a and exceptions leave a intact
+    list& operator=(const list& lst) {
+        if (this != &lst) {
+            list tmp(lst);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Move assignment: O(1), lst is left empty and the old nodes of this list go away at once
+    list& operator=(list&& lst) {
+        list tmp(move(lst));
+        swap(tmp);
+        return *this;
+    }
+
+    void swap(list& other) {
+        std::swap(head, other.head);
+        std::swap(cursor, other.cursor);
+        std::swap(tail, other.tail);
+        std::swap(pool, other.pool);
+        std::swap(adopted, other.adopted);
+    }
+
+    // Destructor: a list that owns its pool alone frees all its nodes with the pool's blocks;
+    // nodes of a shared pool are handed back to it one by one for reuse. Once nodes of other
+    // pools have been spliced in, they stay in their pools until those go away.
     ~list() {
-        for (cursor = head; cursor != 0;) {
-            cursor = head->next; // Move cursor to the next element
-            delete head;         // Delete the current element
-            head = cursor;       // Update the head to the next element
+        if (pool && pool.use_count() > 1 && adopted.empty()) {
+            for (cursor = head; cursor != 0;) {
+                cursor = head->next; // Move cursor to the next element
+                pool->destroy(head); // Return the current element to the pool
+                head = cursor;       // Update the head to the next element
+            }
         }
     }
 
     void prepend(int n); // Insert value n at the front
+    void splice(list& other); // Move all elements of other to the end of this list in O(1)
+    void splice(list&& other) { splice(other); }
     int get_element() { return cursor->d; } // Get the data of the current element
     void advance() { cursor = cursor->next; } // Move the cursor to the next element
     void print(); // Print all elements in the list
     void reset_cursor() { cursor = head; } // Reset cursor to the head of the list
 
+    // Call f(x) for every element, front to back, without touching the cursor
+    template <class F>
+    void for_each(F f) const {
+        for (const list_element* e = head; e != 0; e = e->next)
+            f(e->d);
+    }
+
+    bool empty() const { return head == 0; }
+    iterator begin() { return iterator(head); }
+    iterator end() { return iterator(); }
+    const_iterator begin() const { return const_iterator(head); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
 private:
     list_element* head; // Pointer to the first element
     list_element* cursor; // Pointer for traversal
+    list_element* tail; // Pointer to the last element, for O(1) splice
+    shared_ptr<node_pool<list_element>> pool; // Where the nodes live
+    vector<shared_ptr<node_pool<list_element>>> adopted; // Pools of nodes spliced in from other lists
 };
 
+inline void swap(list& a, list& b) { a.swap(b); }
+
+// Concatenation of two lists passed by value: with moved-in arguments nothing is copied
+inline list concatenate(list a, list b) {
+    a.splice(b);
+    return a;
+}
+
 // Implementation of prepend method
 void list::prepend(int n) {
+    if (!pool) // A moved-from list gets a new pool
+        pool = make_shared<node_pool<list_element>>();
     if (head == 0) // Case: Empty list
-        cursor = head = new list_element(n, head);
+        cursor = tail = head = pool->create(n, head);
     else // Case: Non-empty list
-        head = new list_element(n, head);
+        head = pool->create(n, head);
+}
+
+// Implementation of splice method
+void list::splice(list& other) {
+    if (this == &other || other.head == 0)
+        return;
+    // The nodes stay where they are; this list keeps their pools alive from now on
+    if (other.pool != pool)
+        adopted.push_back(other.pool);
+    for (auto& p : other.adopted)
+        if (p != pool)
+            adopted.push_back(move(p));
+    other.adopted.clear();
+
+    if (head == 0)
+        cursor = head = other.head;
+    else
+        tail->next = other.head;
+    tail = other.tail;
+    other.head = other.cursor = other.tail = 0;
 }
 
 // Implementation of print method
@@ -82,8 +220,149 @@ void list::print() {
     cout << "###" << endl; // End of the list marker
 }
 
+// Time prepend, copy, traversal and destruction of n elements for one list type
+template <class List>
+void bench_list(const char* name, int n) {
+    auto seconds_since = [](chrono::steady_clock::time_point t0) {
+        return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    };
+    long long sum = 0;
+    double prepend_s, copy_s, traverse_s, destroy_s;
+    {
+        auto t0 = chrono::steady_clock::now();
+        List* a = new List;
+        for (int i = 0; i < n; ++i)
+            a->prepend(i);
+        prepend_s = seconds_since(t0);
+
+        t0 = chrono::steady_clock::now();
+        List* b = new List(*a);
+        copy_s = seconds_since(t0);
+
+        t0 = chrono::steady_clock::now();
+        b->for_each([&](int x) { sum += x; });
+        traverse_s = seconds_since(t0);
+
+        t0 = chrono::steady_clock::now();
+        delete a;
+        delete b;
+        destroy_s = seconds_since(t0) / 2;
+    }
+    cout << name << ": prepend " << prepend_s * 1000 << " ms, copy " << copy_s * 1000
+        << " ms, traverse " << traverse_s * 1000 << " ms (" << n / traverse_s / 1e6 << " M elements/s), destroy "
+        << destroy_s * 1000 << " ms, sum " << sum << endl; // printing the sum keeps the traversal alive
+}
+
+// forward_list with prepend / for_each, the one-new-per-node baseline
+struct heap_list : forward_list<int> {
+    void prepend(int x) { push_front(x); }
+    template <class F>
+    void for_each(F f) const {
+        for (int x : *this)
+            f(x);
+    }
+};
+
+// Usage: LinkedLists bench [elements]
+int run_benchmark(int argc, char* argv[]) {
+    int n = argc > 2 ? atoi(argv[2]) : 10000000;
+    cout << n << " elements" << endl;
+    bench_list<heap_list>("new per node (forward_list)", n);
+    bench_list<list>("list, pooled nodes         ", n);
+    bench_list<unrolled_list>("unrolled_list, 13 per node ", n);
+    return 0;
+}
+
+// list behind a mutex, the baseline for concurrent_list
+class locked_list {
+public:
+    void prepend(int n) {
+        lock_guard<mutex> lock(m);
+        l.prepend(n);
+    }
+
+    // Take all the elements; the nodes are freed outside the lock, with their pool
+    list detach() {
+        lock_guard<mutex> lock(m);
+        return move(l);
+    }
+
+    template <class F>
+    void for_each(F f) {
+        lock_guard<mutex> lock(m);
+        l.for_each(f);
+    }
+
+private:
+    mutex m;
+    list l;
+};
+
+// Sum and count of the elements of what detach() returned
+template <class Batch>
+void drain(const Batch& b, long long& sum, long long& count) {
+    b.for_each([&](int x) { sum += x; ++count; });
+}
+
+// 'producers' threads prepend ops elements in total while one consumer keeps detaching
+// and one reader keeps walking the live list. Returns millions of prepends per second.
+template <class List>
+double bench_producers(int producers, int ops) {
+    List l;
+    atomic<int> running(producers);
+    long long sum = 0, count = 0, expected_sum = 0;
+    const int per_thread = ops / producers;
+
+    auto t0 = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_thread; ++i)
+                l.prepend(p + i);
+            --running;
+        });
+    thread reader([&] {
+        long long seen = 0;
+        while (running > 0)
+            l.for_each([&](int) { ++seen; });
+    });
+    while (running > 0)
+        drain(l.detach(), sum, count);
+    for (auto& t : threads)
+        t.join();
+    reader.join();
+    drain(l.detach(), sum, count);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    for (int p = 0; p < producers; ++p)
+        expected_sum += per_thread * static_cast<long long>(p) + per_thread * (per_thread - 1LL) / 2;
+    if (count != static_cast<long long>(per_thread) * producers || sum != expected_sum)
+        cout << "lost elements: " << count << " of " << static_cast<long long>(per_thread) * producers << endl;
+    return count / seconds / 1e6;
+}
+
+// Usage: LinkedLists concurrent [prepends] [max producers]
+int run_concurrent_benchmark(int argc, char* argv[]) {
+    int ops = argc > 2 ? atoi(argv[2]) : 4000000;
+    int max_producers = argc > 3 ? atoi(argv[3]) : 64;
+    cout << ops << " prepends, one consumer detaching, one reader walking the live list, "
+        << thread::hardware_concurrency() << " hardware threads" << endl;
+    cout << "producers  mutex list (M/s)  lock-free (M/s)" << endl;
+    for (int p = 1; p <= max_producers; p *= 2) {
+        double locked = bench_producers<locked_list>(p, ops);
+        double lock_free = bench_producers<concurrent_list>(p, ops);
+        cout << p << "\t   " << locked << "\t\t     " << lock_free << endl;
+    }
+    return 0;
+}
+
 // Main function to test the list class
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "bench")
+        return run_benchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "concurrent")
+        return run_concurrent_benchmark(argc, argv);
+
     list myList;
 
     // Test prepend method
@@ -121,5 +400,23 @@ int main() {
     cout << "list c (copy of list a): " << endl;
     c.print();
 
+    // Test copy and move assignment
+    c = b;
+    cout << "list c after c = b: " << endl;
+    c.print();
+    list d = move(c); // c is left empty
+    cout << "list d (moved from c), c is " << (c.empty() ? "empty" : "not empty") << endl;
+
+    // Test iterators with <algorithm>
+    cout << "sum of list d: " << accumulate(d.begin(), d.end(), 0) << endl;
+    auto found = find(d.begin(), d.end(), 400);
+    cout << "400 " << (found != d.end() ? "found" : "not found") << " in list d" << endl;
+    replace(d.begin(), d.end(), 0, -1);
+
+    // Test splice: a + d without copying a node
+    list e = concatenate(move(a), move(d));
+    cout << "list e (a followed by d): " << endl;
+    e.print();
+
     return 0;
 }
@@ -0,0 +1,105 @@
+// List_Pool.h : Slab allocator for the nodes of the linked lists.
+//
+/*
+new/delete per node costs a trip through the general-purpose heap for every prepend and every
+copied element, and scatters the nodes over memory. A node_pool instead carves nodes out of
+large blocks (64 nodes at first, doubling up to 65536 per block), so building a list of n
+elements does about log2(n) allocations and consecutive prepends sit next to each other.
+
+- create() takes a node from the free list, or the next unused slot of the current block.
+- destroy() puts a single node back on the free list for reuse.
+- Blocks are only released when the pool itself goes away, all at once. A list that is the
+  only owner of its pool therefore frees all its nodes without visiting them.
+
+Slots are aligned to alignof(Node) even above the 16 bytes operator new guarantees, so a node
+declared alignas(64) starts on a cache line.
+
+A pool can be shared between lists (it is held by std::shared_ptr) so that nodes can later move
+between them; it is not thread-safe, so lists sharing a pool must stay on one thread.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+template <class Node>
+class node_pool {
+public:
+    enum : size_t { FIRST_BLOCK = 64, MAX_BLOCK = 65536 };
+
+    node_pool() : free_list(nullptr), next_slot(nullptr), block_end(nullptr), next_block(FIRST_BLOCK), live(0) {}
+
+    node_pool(const node_pool&) = delete;
+    node_pool& operator=(const node_pool&) = delete;
+
+    // Nodes must not need destruction: the pool frees whole blocks without visiting them
+    ~node_pool() = default;
+
+    template <class... Args>
+    Node* create(Args&&... args) {
+        slot* s = free_list;
+        if (s)
+            free_list = s->next_free;
+        else {
+            if (next_slot == block_end)
+                add_block(next_block);
+            s = next_slot++;
+        }
+        ++live;
+        return new (s->storage) Node(std::forward<Args>(args)...);
+    }
+
+    void destroy(Node* n) {
+        n->~Node();
+        slot* s = reinterpret_cast<slot*>(n);
+        s->next_free = free_list;
+        free_list = s;
+        --live;
+    }
+
+    // Make sure the next 'n' creates need at most one more allocation
+    void reserve(size_t n) {
+        size_t spare = static_cast<size_t>(block_end - next_slot);
+        if (spare < n)
+            add_block(n - spare);
+    }
+
+    size_t size() const { return live; }
+    size_t capacity() const { return total; }
+    size_t blocks() const { return storage.size(); }
+    size_t bytes() const { return total * sizeof(slot); }
+
+private:
+    union slot {
+        slot* next_free;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    std::vector<std::unique_ptr<unsigned char[]>> storage;   // raw blocks, slots start at the first aligned byte
+    slot* free_list;
+    slot* next_slot;
+    slot* block_end;
+    size_t next_block;
+    size_t live;
+    size_t total = 0;
+
+    void add_block(size_t n) {
+        for (; next_slot != block_end; ++next_slot) { // keep the tail of the old block
+            next_slot->next_free = free_list;
+            free_list = next_slot;
+        }
+        n = std::max<size_t>(n, next_block);
+        size_t space = n * sizeof(slot) + alignof(slot) - 1;
+        storage.emplace_back(new unsigned char[space]);
+        void* first = storage.back().get();
+        std::align(alignof(slot), n * sizeof(slot), first, space);
+        next_slot = static_cast<slot*>(first);
+        block_end = next_slot + n;
+        total += n;
+        next_block = std::min<size_t>(MAX_BLOCK, next_block * 2);
+    }
+};
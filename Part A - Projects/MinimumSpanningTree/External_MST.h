@@ -0,0 +1,350 @@
+// External_MST.h : Minimum spanning tree of edge files larger than memory.
+//
+/*
+Graph(filename) keeps a dense V x V matrix, 8 * V^2 bytes: 3.2 GB for 20000 nodes, 320 GB for
+200000, before primMST starts. external_mst reads the same file format (the number of nodes, then
+one "i j cost" line per edge) and keeps only what Kruskal's algorithm needs in memory:
+
+1. Run formation: edges are read into a buffer; each time it is full it is sorted by cost and
+   written to a temporary binary file (a run of 16-byte records).
+2. Merge: the runs are merged, one buffer of records per run. If there are too many runs for the
+   buffers to stay large (at least MIN_BLOCK records each), groups of runs are first merged into
+   longer runs, as many passes as it takes.
+3. Kruskal: the last merge feeds edges in increasing cost order straight to a union-find over the
+   nodes (parent and rank, 5 bytes per node); an edge joining two different trees is kept. It
+   stops as soon as V - 1 edges are kept.
+
+Memory: the union-find is allocated first, and everything else (the run buffer, then the merge
+buffers) shares what is left of memory_limit, so the peak stays under the limit. peak_memory in
+the report counts these buffers, which are nearly all the memory used; the streams and the
+program itself come on top. A limit too small for the union-find of V nodes throws.
+
+As in Graph, a cost of 0 (or less) means no edge. A pair listed more than once counts with its
+cheapest cost, where Graph keeps the last line's. If the graph is not connected the result is a
+minimum spanning forest, one tree per component (Prim from node 0 only spans node 0's component).
+Temporary files go to temp_dir and are removed when done, also on errors.
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct external_edge {
+    uint32_t u;
+    uint32_t v;
+    double cost;
+};
+
+inline bool operator<(const external_edge& a, const external_edge& b) { return a.cost < b.cost; }
+
+struct external_mst_options {
+    size_t memory_limit = 64 << 20;     // bytes for the union-find and all buffers
+    std::string temp_dir = ".";         // where the sorted runs are written
+    std::ostream* tree_out = nullptr;   // if set, receives the MST edges as "i j cost" lines
+};
+
+struct external_mst_report {
+    uint64_t nodes = 0;
+    uint64_t edges_read = 0;
+    uint64_t runs = 0;            // sorted runs written by run formation
+    int merge_passes = 0;         // merges into new runs, before the final one
+    uint64_t edges_merged = 0;    // edges Kruskal looked at before the tree was complete
+    uint64_t tree_edges = 0;
+    uint64_t components = 0;      // 1 for a connected graph
+    double total_cost = 0.0;
+    size_t memory_limit = 0;
+    size_t peak_memory = 0;
+    double read_seconds = 0.0;    // reading, sorting and writing runs
+    double merge_seconds = 0.0;   // intermediate merge passes
+    double kruskal_seconds = 0.0; // final merge and union-find
+};
+
+namespace external_mst_detail {
+
+    enum : size_t { MIN_BLOCK = 4096 };   // records per merge buffer (64 KB)
+
+    // Bytes held by the buffers, and their peak
+    class memory_meter {
+    public:
+        memory_meter(size_t limit) : limit(limit), current(0), peak(0) {}
+
+        void acquire(size_t bytes) {
+            current += bytes;
+            peak = std::max(peak, current);
+        }
+        void release(size_t bytes) { current -= bytes; }
+        size_t available() const { return limit > current ? limit - current : 0; }
+        size_t highest() const { return peak; }
+
+    private:
+        size_t limit;
+        size_t current;
+        size_t peak;
+    };
+
+    // A temporary file of edges, removed when destroyed
+    class run_file {
+    public:
+        explicit run_file(const std::string& path) : path(path), records(0) {}
+        run_file(const run_file&) = delete;
+        run_file& operator=(const run_file&) = delete;
+        ~run_file() { std::remove(path.c_str()); }
+
+        void write(const external_edge* edges, size_t count) {
+            std::FILE* f = std::fopen(path.c_str(), records ? "ab" : "wb");
+            if (!f)
+                throw std::runtime_error("cannot write " + path);
+            size_t written = std::fwrite(edges, sizeof(external_edge), count, f);
+            std::fclose(f);
+            if (written != count)
+                throw std::runtime_error("cannot write " + path + " (disk full?)");
+            records += count;
+        }
+
+        const std::string path;
+        uint64_t records;
+    };
+
+    // Reads a run back one block at a time
+    class run_reader {
+    public:
+        run_reader(const run_file& run, size_t block, memory_meter& meter)
+            : meter(meter), buffer(block), next(0), filled(0) {
+            file = std::fopen(run.path.c_str(), "rb");
+            if (!file)
+                throw std::runtime_error("cannot read " + run.path);
+            meter.acquire(buffer.capacity() * sizeof(external_edge));
+            std::setvbuf(file, nullptr, _IONBF, 0);
+            refill();
+        }
+        run_reader(const run_reader&) = delete;
+        run_reader& operator=(const run_reader&) = delete;
+        ~run_reader() {
+            std::fclose(file);
+            meter.release(buffer.capacity() * sizeof(external_edge));
+        }
+
+        bool done() const { return next == filled; }
+        const external_edge& front() const { return buffer[next]; }
+        void pop() {
+            if (++next == filled)
+                refill();
+        }
+
+    private:
+        memory_meter& meter;
+        std::vector<external_edge> buffer;
+        std::FILE* file;
+        size_t next;
+        size_t filled;
+
+        void refill() {
+            filled = std::fread(buffer.data(), sizeof(external_edge), buffer.size(), file);
+            next = 0;
+        }
+    };
+
+    // Merges runs[first, last) in cost order, handing each edge to 'sink' until it returns false
+    inline void merge_runs(const std::vector<std::unique_ptr<run_file>>& runs, size_t first, size_t last,
+        size_t block, memory_meter& meter, const std::function<bool(const external_edge&)>& sink)
+    {
+        std::vector<std::unique_ptr<run_reader>> readers;
+        for (size_t r = first; r < last; ++r)
+            readers.emplace_back(new run_reader(*runs[r], block, meter));
+
+        // (cost, reader) min-heap; ties go to the earlier run, so the order is deterministic
+        typedef std::pair<double, size_t> head;
+        std::priority_queue<head, std::vector<head>, std::greater<head>> heap;
+        for (size_t r = 0; r < readers.size(); ++r)
+            if (!readers[r]->done())
+                heap.push({ readers[r]->front().cost, r });
+        while (!heap.empty()) {
+            size_t r = heap.top().second;
+            heap.pop();
+            if (!sink(readers[r]->front()))
+                return;
+            readers[r]->pop();
+            if (!readers[r]->done())
+                heap.push({ readers[r]->front().cost, r });
+        }
+    }
+
+    // Union-find with path halving and union by rank
+    class disjoint_sets {
+    public:
+        explicit disjoint_sets(uint32_t n) : parent(n), rank(n, 0) {
+            for (uint32_t i = 0; i < n; ++i)
+                parent[i] = i;
+        }
+
+        uint32_t find(uint32_t x) {
+            while (parent[x] != x) {
+                parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        }
+
+        // Joins the sets of a and b; false if they were already one
+        bool unite(uint32_t a, uint32_t b) {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return false;
+            if (rank[a] < rank[b])
+                std::swap(a, b);
+            parent[b] = a;
+            if (rank[a] == rank[b])
+                rank[a]++;
+            return true;
+        }
+
+        static size_t bytes_per_node() { return sizeof(uint32_t) + sizeof(uint8_t); }
+
+    private:
+        std::vector<uint32_t> parent;
+        std::vector<uint8_t> rank;
+    };
+
+    inline double seconds_since(std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+}
+
+// Kruskal's MST of an edge file in at most options.memory_limit bytes of buffers
+inline external_mst_report external_mst(const std::string& filename, const external_mst_options& options = external_mst_options())
+{
+    using namespace external_mst_detail;
+    external_mst_report report;
+    report.memory_limit = options.memory_limit;
+    memory_meter meter(options.memory_limit);
+
+    std::ifstream file(filename, std::ios::ate);
+    if (!file)
+        throw std::runtime_error("cannot open " + filename);
+    const uint64_t file_bytes = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    long long n = -1;
+    if (!(file >> n) || n < 0 || n > 0xFFFFFFFFLL)
+        throw std::runtime_error(filename + ": bad node count");
+    report.nodes = static_cast<uint64_t>(n);
+
+    const size_t forest_bytes = static_cast<size_t>(n) * disjoint_sets::bytes_per_node();
+    if (forest_bytes + MIN_BLOCK * sizeof(external_edge) > options.memory_limit)
+        throw std::runtime_error("a memory limit of " + std::to_string(options.memory_limit) + " bytes is too small for " +
+            std::to_string(n) + " nodes");
+    meter.acquire(forest_bytes);
+    disjoint_sets forest(static_cast<uint32_t>(n));
+
+    // 1. Sorted runs of as many edges as fit in the rest of the budget
+    auto t0 = std::chrono::steady_clock::now();
+    const std::string stamp = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    std::vector<std::unique_ptr<run_file>> runs;
+    auto new_run = [&]() {
+        runs.emplace_back(new run_file(options.temp_dir + "/mst_" + stamp + "_" + std::to_string(runs.size()) + ".run"));
+        return runs.back().get();
+    };
+
+    std::vector<external_edge> buffer;
+    {
+        // no more than the file can hold: an edge line takes at least 6 characters ("0 1 1\n")
+        const size_t capacity = static_cast<size_t>(std::min<uint64_t>(meter.available() / sizeof(external_edge), file_bytes / 6 + 1));
+        buffer.reserve(capacity);
+        meter.acquire(buffer.capacity() * sizeof(external_edge));
+        long long i, j;
+        double cost;
+        while (file >> i >> j >> cost) {
+            if (i < 0 || j < 0 || i >= n || j >= n)
+                throw std::runtime_error(filename + ": edge " + std::to_string(i) + " - " + std::to_string(j) + " out of range");
+            report.edges_read++;
+            if (cost <= 0.0 || i == j)
+                continue;
+            buffer.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(j), cost });
+            if (buffer.size() == capacity) {
+                std::sort(buffer.begin(), buffer.end());
+                new_run()->write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        std::sort(buffer.begin(), buffer.end());
+        if (!runs.empty() && !buffer.empty()) {
+            new_run()->write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    report.runs = runs.size();
+    report.read_seconds = seconds_since(t0);
+
+    // 3. Kruskal: in cost order, an edge joining two trees is kept
+    auto kruskal = [&](const external_edge& e) {
+        report.edges_merged++;
+        if (forest.unite(e.u, e.v)) {
+            report.tree_edges++;
+            report.total_cost += e.cost;
+            if (options.tree_out)
+                *options.tree_out << e.u << " " << e.v << " " << e.cost << "\n";
+        }
+        return report.tree_edges + 1 < report.nodes;
+    };
+
+    if (runs.empty()) {
+        // Everything fit in one buffer: no files at all
+        t0 = std::chrono::steady_clock::now();
+        for (const external_edge& e : buffer)
+            if (!kruskal(e))
+                break;
+    }
+    else {
+        meter.release(buffer.capacity() * sizeof(external_edge));
+        std::vector<external_edge>().swap(buffer);
+
+        // 2. Merge passes until one merge can take all runs with blocks of at least MIN_BLOCK
+        t0 = std::chrono::steady_clock::now();
+        const size_t fan_in = std::max<size_t>(2, meter.available() / (MIN_BLOCK * sizeof(external_edge)) - 1);
+        size_t first = 0;
+        while (runs.size() - first > fan_in) {
+            report.merge_passes++;
+            const size_t last = runs.size();
+            for (size_t group = first; group < last; group += fan_in) {
+                const size_t end = std::min(last, group + fan_in);
+                const size_t block = meter.available() / (end - group + 1) / sizeof(external_edge);
+                run_file* out = new_run();
+                std::vector<external_edge> output;
+                output.reserve(block);
+                meter.acquire(output.capacity() * sizeof(external_edge));
+                merge_runs(runs, group, end, block, meter, [&](const external_edge& e) {
+                    output.push_back(e);
+                    if (output.size() == block) {
+                        out->write(output.data(), output.size());
+                        output.clear();
+                    }
+                    return true;
+                });
+                out->write(output.data(), output.size());
+                meter.release(output.capacity() * sizeof(external_edge));
+                for (size_t r = group; r < end; ++r)
+                    runs[r].reset();   // merged: remove the file now
+            }
+            first = last;
+        }
+        report.merge_seconds = seconds_since(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        const size_t block = meter.available() / (runs.size() - first) / sizeof(external_edge);
+        merge_runs(runs, first, runs.size(), block, meter, kruskal);
+    }
+    report.kruskal_seconds = seconds_since(t0);
+    report.components = report.nodes - report.tree_edges;
+    report.peak_memory = meter.highest();
+    return report;
+}
@@ -1,12 +1,20 @@
 // MinimumSpanningTree.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <queue>
 #include <limits>
 #include <fstream>
 #include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <stdexcept>
+
+#include "../../Common/Fast_Random.h"
+#include "../../Common/Graph_Stats.h"
+#include "External_MST.h"
 
 using namespace std;
 
@@ -14,6 +22,7 @@ class Graph {
 private:
     int nodes;
     vector<vector<double>> AdjacencyMatrix;
+    graph_stats last_stats; // Counters of the last primMST run (Graph_Stats.h)
 
 public:
     // Default Constructor
@@ -61,6 +70,9 @@ public:
             return;
         }
 
+        GRAPH_STAT(last_stats.reset("prim", nodes));
+        GRAPH_STAT(graph_phase_clock clock);
+
         vector<double> key(nodes, numeric_limits<double>::max()); // Store min edge weights
         vector<int> parent(nodes, -1); // Stores MST structure
         vector<bool> inMST(nodes, false); // Track included nodes
@@ -71,24 +83,36 @@ public:
         // Start with node 0
         key[0] = 0;
         pq.push({ 0, 0 });
+        GRAPH_STAT(last_stats.heap_pushes++);
+        GRAPH_STAT(clock.lap(last_stats.init_seconds));
 
         while (!pq.empty()) {
             int u = pq.top().second; // Get the node with the smallest weight
             pq.pop();
+            GRAPH_STAT(last_stats.heap_pops++);
 
-            if (inMST[u]) continue; // If already in MST, skip
+            if (inMST[u]) { // If already in MST, skip
+                GRAPH_STAT(last_stats.stale_pops++);
+                continue;
+            }
             inMST[u] = true;
+            GRAPH_STAT(last_stats.nodes_settled++);
 
             // Examine adjacent nodes
             for (int v = 0; v < nodes; ++v) {
                 double weight = AdjacencyMatrix[u][v];
+                GRAPH_STAT(last_stats.edges_scanned++);
+                GRAPH_STAT(last_stats.edges_found += weight > 0);
                 if (weight > 0 && !inMST[v] && weight < key[v]) {
                     key[v] = weight;
                     parent[v] = u;
                     pq.push({ key[v], v });
+                    GRAPH_STAT(last_stats.relaxations++);
+                    GRAPH_STAT(last_stats.heap_pushes++);
                 }
             }
         }
+        GRAPH_STAT(clock.lap(last_stats.search_seconds));
 
         // Print MST
         cout << "Edges in Minimum Spanning Tree:\n";
@@ -100,12 +124,94 @@ public:
             }
         }
         cout << "Total MST Cost: " << totalCost << endl;
+        GRAPH_STAT(clock.lap(last_stats.output_seconds));
     }
+
+    // Counters of the last primMST run, if compiled in
+    const graph_stats& stats() const { return last_stats; }
 };
 
-int main() {
+// Usage: MinimumSpanningTree external <edge file> [memory MB] [temp dir] [tree file]
+// Kruskal's MST of a file in the format read by Graph(filename), in bounded memory (External_MST.h)
+int run_external(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: MinimumSpanningTree external <edge file> [memory MB] [temp dir] [tree file]" << endl;
+        return 1;
+    }
+    external_mst_options options;
+    if (argc > 3)
+        options.memory_limit = static_cast<size_t>(atof(argv[3]) * (1 << 20));
+    if (argc > 4)
+        options.temp_dir = argv[4];
+    ofstream tree;
+    if (argc > 5) {
+        tree.open(argv[5]);
+        options.tree_out = &tree;
+    }
+
+    try {
+        external_mst_report r = external_mst(argv[2], options);
+        cout << r.nodes << " nodes, " << r.edges_read << " edges read, " << r.runs << " sorted runs, "
+            << r.merge_passes << " intermediate merge passes" << endl;
+        cout << "MST: " << r.tree_edges << " edges (" << r.edges_merged << " edges merged), "
+            << r.components << (r.components == 1 ? " component" : " components") << endl;
+        cout << "Total MST Cost: " << fixed << setprecision(2) << r.total_cost << endl;
+        cout << "Peak memory: " << r.peak_memory / 1048576.0 << " of " << r.memory_limit / 1048576.0 << " MB" << endl;
+        cout << "Seconds: runs " << setprecision(3) << r.read_seconds << ", merge passes " << r.merge_seconds
+            << ", Kruskal " << r.kruskal_seconds << endl;
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Usage: MinimumSpanningTree generate <edge file> <nodes> [edges per node] [seed]
+// A random connected graph in the same format: each node after the first is joined to up to
+// [edges per node] distinct earlier nodes, with integer costs from 1 to 1000. Every pair appears
+// once and there are no self-loops, so Prim and the external Kruskal read the same graph.
+int run_generate(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Usage: MinimumSpanningTree generate <edge file> <nodes> [edges per node] [seed]" << endl;
+        return 1;
+    }
+    long long n = atoll(argv[3]);
+    int per_node = argc > 4 ? atoi(argv[4]) : 8;
+    xoshiro256ss rng(argc > 5 ? strtoull(argv[5], 0, 10) : 1);
+    ofstream out(argv[2]);
+    if (!out || n < 1) {
+        cerr << "Error: Cannot write file!" << endl;
+        return 1;
+    }
+    out << n << "\n";
+    vector<long long> earlier;  // partners of v, each pair written only from its larger node
+    for (long long v = 1; v < n; ++v) {
+        earlier.clear();
+        size_t k = static_cast<size_t>(min<long long>(max(per_node, 1), v));
+        while (earlier.size() < k) {
+            long long u = uniform_int(rng, 0LL, v - 1);
+            if (find(earlier.begin(), earlier.end(), u) == earlier.end())
+                earlier.push_back(u);
+        }
+        for (long long u : earlier)
+            out << u << " " << v << " " << uniform_int(rng, 1, 1000) << "\n";
+    }
+    return out ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "external")
+        return run_external(argc, argv);
+    if (argc > 1 && string(argv[1]) == "generate")
+        return run_generate(argc, argv);
+
     Graph g("SampleTestData_mst_data.txt"); // Read graph from file
     g.printGraph();  // Print adjacency matrix
     g.primMST();     // Run Prim's algorithm and output MST
+    if (graph_stats::enabled) {
+        g.stats().write_json(cout);
+        cout << endl;
+    }
     return 0;
 }
@@ -6,200 +6,294 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <chrono>
 #include <ctime>
 #include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "Poker_Cards.h"
+#include "Poker_Eval.h"
+#include "Poker_CardSet.h"
+#include "Poker_Simulation.h"
+#include "Poker_Enumeration.h"
+#include "Poker_Equity.h"
+#include "Poker_Batch.h"
 
 using namespace std;
 
-enum class suit { SPADE, HEART, DIAMOND, CLUB };
-
-class pips {
-    int value;
-public:
-    pips(int v = 1) : value(v) {}
-    int get_pips() const { return value; }
-
-    // Allow pips to be printed directly
-    friend ostream& operator<<(ostream& out, const pips& p) {
-        out << p.value;
-        return out;
+// Estimate the frequency of every hand category on all cores.
+// Usage: Card_Poker_Class simulate [trials] [threads] [cards per hand] [seed]
+int run_simulation(int argc, char* argv[]) {
+    simulation_config cfg;
+    long long trials = argc > 2 ? stoll(argv[2]) : static_cast<long long>(cfg.trials);
+    if (argc > 3) cfg.threads = atoi(argv[3]);
+    if (argc > 4) cfg.cards = atoi(argv[4]);
+    if (argc > 5) cfg.seed = stoull(argv[5]);
+    if (trials < 1) {
+        cerr << "Need at least 1 trial." << endl;
+        return 1;
     }
-
-    // Comparison operator to allow use in maps, sorting, etc.
-    bool operator<(const pips& other) const {
-        return value < other.value;
+    if (cfg.cards < 5 || cfg.cards > 7) {
+        cerr << "Hands must have 5 to 7 cards." << endl;
+        return 1;
     }
-};
+    cfg.trials = static_cast<uint64_t>(trials);
 
-class card {
-public:
-    card() : s(suit::SPADE), v(1) {}
-    card(suit s, pips v) : s(s), v(v) {}
+    simulation_result res = simulate_hands(cfg);
+    cout << res.counts.trials << " hands of " << cfg.cards << " cards on " << res.threads << " threads in "
+        << res.seconds << "s (" << res.hands_per_second() / 1e6 << " M hands/s)\n\n";
+    print_frequencies(cout, res.counts);
+    return 0;
+}
 
-    suit get_suit() const { return s; }
-    pips get_pips() const { return v; }
+// Count every hand category exactly and check the table evaluator against the predicates.
+// Usage: Card_Poker_Class enumerate [cards per hand] [threads]
+int run_enumeration(int argc, char* argv[]) {
+    int cards = argc > 2 ? atoi(argv[2]) : 5;
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    if (cards < 5 || cards > 7) {
+        cerr << "Hands must have 5 to 7 cards." << endl;
+        return 1;
+    }
 
-    friend ostream& operator<<(ostream& out, const card& c) {
-        // Custom output assumes enums are handled as ints or symbols
-        const char* suits[] = { "S", "H", "D", "C" };
-        out << c.v << suits[static_cast<int>(c.s)];
-        return out;
+    enumeration_result res = enumerate_hands(cards, threads);
+    cout << res.counts.trials << " hands of " << cards << " cards on " << res.threads << " threads in "
+        << res.seconds << "s (" << res.hands_per_second() / 1e6 << " M hands/s)\n\n";
+    cout << "Flushes: " << res.flushes << " out of " << res.counts.trials << endl;
+    cout << "Straights: " << res.straights << " out of " << res.counts.trials << endl;
+    cout << "Straight Flushes: " << res.straight_flushes << " out of " << res.counts.trials << endl << endl;
+    print_frequencies(cout, res.counts, false);
+
+    if (res.mismatches == 0) {
+        cout << "\nTable evaluator agrees on all " << res.counts.trials << " hands." << endl;
+        return 0;
     }
+    int first[7];
+    combination_at(res.first_mismatch, cards, first);
+    card_set hand;
+    for (int i = 0; i < cards; ++i)
+        hand.add_index(first[i]);
+    cout << "\nTable evaluator disagrees on " << res.mismatches << " hands, first: " << hand
+        << "(" << category_name(predicate_category(hand)) << " vs " << category_name(hand.category()) << ")" << endl;
+    return 2;
+}
 
-private:
-    suit s;
-    pips v;
-};
+// Hold'em equity of two or more hands, e.g. "equity AsKd QhQc board=Jh9d2c".
+// Usage: Card_Poker_Class equity <hand> <hand> [...] [board=cards] [threads=N] [se=target standard error]
+//        [exhaustive=max boards enumerated] [max_boards=N] [seed=N]
+int run_equity(int argc, char* argv[]) {
+    equity_config cfg;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = eq == string::npos ? "" : arg.substr(0, eq);
+        string value = eq == string::npos ? arg : arg.substr(eq + 1);
+        bool ok = true;
+        if (key.empty()) {
+            vector<int> hand;
+            ok = parse_cards(value, hand) && hand.size() == 2;
+            cfg.hands.push_back(hand);
+        }
+        else if (key == "board") ok = parse_cards(value, cfg.board) && cfg.board.size() <= 5;
+        else if (key == "threads") cfg.threads = atoi(value.c_str());
+        else if (key == "se") cfg.target_stderr = atof(value.c_str());
+        else if (key == "exhaustive") cfg.max_exhaustive = stoull(value);
+        else if (key == "max_boards") cfg.max_boards = stoull(value);
+        else if (key == "seed") cfg.seed = stoull(value);
+        else ok = false;
+        if (!ok) {
+            cerr << "Bad argument: " << arg << endl;
+            return 1;
+        }
+    }
 
-void init_deck(vector<card>& d) {
-    for (int i = 1; i < 14; ++i) {
-        card c(suit::SPADE, i);
-        d[i - 1] = c;
+    card_set used;
+    size_t n_cards = cfg.board.size();
+    for (int c : cfg.board)
+        used.add_index(c);
+    for (const auto& h : cfg.hands) {
+        n_cards += h.size();
+        for (int c : h)
+            used.add_index(c);
     }
-    for (int i = 1; i < 14; ++i) {
-        card c(suit::HEART, i);
-        d[i + 12] = c;
+    if (cfg.hands.size() < 2 || static_cast<size_t>(used.size()) != n_cards) {
+        cerr << "Need at least two hands and no card twice." << endl;
+        return 1;
     }
-    for (int i = 1; i < 14; ++i) {
-        card c(suit::DIAMOND, i);
-        d[i + 25] = c;
+
+    equity_result res;
+    try {
+        res = compute_equity(cfg);
     }
-    for (int i = 1; i < 14; ++i) {
-        card c(suit::CLUB, i);
-        d[i + 38] = c;
+    catch (const invalid_argument& e) {
+        cerr << e.what() << endl;
+        return 1;
     }
-}
-
-void print(vector<card>& deck) {
-    for (auto p = deck.begin(); p != deck.end(); ++p)
-        cout << *p;
-    cout << endl;
-}
-
-bool is_flush(vector<card>& hand) {
-    suit s = hand[0].get_suit();
-    for (auto p = hand.begin() + 1; p != hand.end(); ++p)
-        if (s != p->get_suit())
-            return false;
-    return true;
-}
-
-bool is_straight(vector<card>& hand) {
-    int pips_v[5], i = 0;
-    for (auto p = hand.begin(); p != hand.end(); ++p)
-        pips_v[i++] = (p->get_pips()).get_pips();
-
-    sort(pips_v, pips_v + 5); // Sort the pip values
-
-    if (pips_v[0] != 1)  // Standard case (no Ace as 1)
-        return (pips_v[0] == pips_v[1] - 1 &&
-            pips_v[1] == pips_v[2] - 1 &&
-            pips_v[2] == pips_v[3] - 1 &&
-            pips_v[3] == pips_v[4] - 1);
-    else  // Special Ace logic: A-2-3-4-5 OR 10-J-Q-K-A
-        return (pips_v[0] == pips_v[1] - 1 &&
-            pips_v[1] == pips_v[2] - 1 &&
-            pips_v[2] == pips_v[3] - 1 &&
-            pips_v[3] == pips_v[4] - 1)
-        ||
-        (pips_v[1] == 10 && pips_v[2] == 11 &&
-            pips_v[3] == 12 && pips_v[4] == 13);
-}
-
-bool is_straight_flush(vector<card>& hand)
-{
-    return is_flush(hand) && is_straight(hand);
-}
-
-bool is_4of_akind(vector<card>& hand) {
-    map<int, int> pip_counts;
-
-    for (auto& c : hand) {
-        int pip = c.get_pips().get_pips();  // Adjust if pips is a primitive
-        pip_counts[pip]++;
+    cout << res.boards << (res.exhaustive ? " boards (exhaustive)" : " boards (Monte Carlo)") << " on "
+        << res.threads << " threads in " << res.seconds << "s ("
+        << res.boards_per_second() / 1e6 << " M boards/s)\n\n";
+    cout << left << setw(12) << "hand" << right << setw(10) << "equity" << setw(10) << "win" << setw(10) << "tie";
+    if (!res.exhaustive)
+        cout << setw(12) << "std error";
+    cout << "\n" << fixed << setprecision(4);
+    for (size_t p = 0; p < res.players.size(); ++p) {
+        card_set hand;
+        for (int c : cfg.hands[p])
+            hand.add_index(c);
+        ostringstream name;
+        name << hand;
+        const player_equity& pe = res.players[p];
+        cout << left << setw(12) << name.str() << right << setw(10) << pe.equity
+            << setw(10) << pe.win << setw(10) << pe.tie;
+        if (!res.exhaustive)
+            cout << setw(12) << pe.std_error;
+        cout << "\n";
     }
-
-    for (auto& entry : pip_counts)
-        if (entry.second == 4)
-            return true;
-
-    return false;
+    return 0;
 }
-bool is_straight_flush_7(vector<card>& hand) {
-    map<suit, vector<int>> suited_pips;
-
-    // Step 1: Organize cards by suit
-    for (auto& c : hand) {
-        suited_pips[c.get_suit()].push_back(c.get_pips().get_pips());
-    }
-
-    // Step 2: Check for a straight in each suit
-    for (auto& suit_pip_pair : suited_pips) {
-        auto& s = suit_pip_pair.first;
-        auto& pips = suit_pip_pair.second;
-
-        if (pips.size() < 5) continue;
-
-        sort(pips.begin(), pips.end());
-        pips.erase(unique(pips.begin(), pips.end()), pips.end());
 
-        // If Ace is present, add 14 to consider Ace-high
-        if (find(pips.begin(), pips.end(), 1) != pips.end()) {
-            pips.push_back(14);
-            sort(pips.begin(), pips.end());
-        }
-
-        int count = 1;
-        for (size_t i = 1; i < pips.size(); ++i) {
-            if (pips[i] == pips[i - 1] + 1)
-                count++;
-            else
-                count = 1;
-
-            if (count >= 5)
-                return true;
+// Hands per second of the scalar predicates against the batch classifier, on the same random 5-card hands.
+// Usage: Card_Poker_Class batchbench [hands]
+int run_batch_benchmark(int argc, char* argv[]) {
+    const int LANES = 16;
+    size_t n = argc > 2 ? stoull(argv[2]) : 2000000;
+    n = (n + LANES - 1) / LANES * LANES;
+
+    vector<card> deck(52);
+    init_deck(deck);
+    xoshiro256ss rng(1);
+    int order[52];
+    for (int i = 0; i < 52; ++i)
+        order[i] = i;
+    vector<vector<card>> hands(n, vector<card>(5));
+    vector<card_set> sets(n);
+    for (size_t h = 0; h < n; ++h) {
+        deal_cards(order, 5, rng);
+        for (int i = 0; i < 5; ++i) {
+            hands[h][i] = deck[order[i]];
+            sets[h].add_index(order[i]);
         }
     }
+    vector<hand_batch<LANES>> batches(n / LANES);
+    for (size_t h = 0; h < n; ++h)
+        batches[h / LANES].set(static_cast<int>(h % LANES), sets[h]);
+
+    auto seconds_since = [](chrono::steady_clock::time_point t0) {
+        return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    };
+
+    // Scalar: the original vector<card> predicates
+    auto t0 = chrono::steady_clock::now();
+    size_t flushes = 0, straights = 0;
+    for (auto& hand : hands) {
+        flushes += is_flush(hand);
+        straights += is_straight(hand);
+    }
+    double scalar = seconds_since(t0);
+
+    // Scalar card_set: the same mask arithmetic, one hand at a time
+    t0 = chrono::steady_clock::now();
+    size_t set_flushes = 0, set_straights = 0, set_category_sum = 0;
+    for (const auto& h : sets) {
+        set_flushes += h.is_flush();
+        set_straights += h.is_straight();
+        set_category_sum += static_cast<int>(predicate_category(h));
+    }
+    double packed = seconds_since(t0);
+
+    // Batch: 16 hands per call, every category at once
+    t0 = chrono::steady_clock::now();
+    size_t batch_flushes = 0, batch_straights = 0, batch_category_sum = 0;
+    batch_result<LANES> res;
+    for (const auto& b : batches) {
+        classify(b, res);
+        batch_flushes += popcount64(res.flush);
+        batch_straights += popcount64(res.straight);
+        for (int l = 0; l < LANES; ++l)
+            batch_category_sum += res.category[l];
+    }
+    double batched = seconds_since(t0);
+
+    size_t mismatches = 0;
+    for (size_t h = 0; h < n; ++h) {
+        classify(batches[h / LANES], res);
+        int l = static_cast<int>(h % LANES);
+        bool f = (res.flush >> l) & 1, st = (res.straight >> l) & 1;
+        if (f != is_flush(hands[h]) || st != is_straight(hands[h]) ||
+            res.category[l] != static_cast<int>(sets[h].category()))
+            ++mismatches;
+    }
 
-    return false;
+#if defined(__AVX2__)
+    const char* kind = "AVX2";
+#else
+    const char* kind = "portable";
+#endif
+    cout << n << " random 5-card hands\n" << fixed << setprecision(1);
+    cout << "is_flush + is_straight (vector<card>): " << n / scalar / 1e6 << " M hands/s\n";
+    cout << "card_set predicates, all categories:    " << n / packed / 1e6 << " M hands/s\n";
+    cout << "hand_batch<" << LANES << "> (" << kind << "), all categories: " << n / batched / 1e6 << " M hands/s\n";
+    cout << "flushes " << flushes << " / " << set_flushes << " / " << batch_flushes
+        << ", straights " << straights << " / " << set_straights << " / " << batch_straights
+        << ", category sums " << set_category_sum << " / " << batch_category_sum << "\n";
+    cout << (mismatches == 0 ? "Batch results match the scalar predicates and the evaluator." : "MISMATCHES: ")
+        << (mismatches ? to_string(mismatches) : string()) << endl;
+    return mismatches == 0 ? 0 : 2;
 }
 
-
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && string(argv[1]) == "simulate")
+        return run_simulation(argc, argv);
+    if (argc > 1 && string(argv[1]) == "enumerate")
+        return run_enumeration(argc, argv);
+    if (argc > 1 && string(argv[1]) == "equity")
+        return run_equity(argc, argv);
+    if (argc > 1 && string(argv[1]) == "batchbench")
+        return run_batch_benchmark(argc, argv);
+
     vector<card> deck(52);       // Create a vector of 52 card objects
     init_deck(deck);             // Fill deck with cards
 
-    // Use C++11 random engine instead of deprecated random_shuffle
-    random_device rd;
-    mt19937 rng(rd());
+    // The shared fast engine (Fast_Random.h), seeded once from the system's entropy source
+    seed_thread_rngs(random_device()());
+    xoshiro256ss& rng = thread_rng();
 
     int how_many;
     int flush_count = 0;
     int str_count = 0;
     int str_flush_count = 0;
+    int category_count[9] = {};  // every hand category, from the table evaluator
 
     cout << "How Many shuffles? ";
     cin >> how_many;
 
     for (int loop = 0; loop < how_many; ++loop) {
-        shuffle(deck.begin(), deck.end(), rng);  // Modern shuffle
+        shuffle_range(deck.begin(), deck.end(), rng);  // Fisher-Yates with unbiased bounded draws
 
-        vector<card> hand(deck.begin(), deck.begin() + 5);  // First 5 cards
+        card_set hand;  // First 5 cards, packed in one word: no allocation per hand
+        for (int i = 0; i < 5; ++i)
+            hand.add(deck[i]);
 
         // Optional: print hand for debugging
-        // for (const auto& c : hand) cout << c << " ";
-        // cout << endl;
+        // cout << hand << endl;
 
-        if (is_flush(hand)) flush_count++;
-        if (is_straight(hand)) str_count++;
-        if (is_straight_flush(hand)) str_flush_count++;
+        if (hand.is_flush()) flush_count++;
+        if (hand.is_straight()) str_count++;
+        if (hand.is_straight_flush()) str_flush_count++;
+        category_count[static_cast<int>(hand.category())]++;
     }
 
     cout << "Flushes: " << flush_count << " out of " << how_many << endl;
     cout << "Straights: " << str_count << " out of " << how_many << endl;
     cout << "Straight Flushes: " << str_flush_count << " out of " << how_many << endl;
 
+    cout << "\nAll categories:" << endl;
+    for (int c = 8; c >= 0; --c)
+        cout << category_name(static_cast<hand_category>(c)) << ": " << category_count[c] << " out of " << how_many << endl;
+
     return 0;
 }
 
@@ -0,0 +1,197 @@
+// Poker_Batch.h : Branch-free classification of many hands at once, 8 hands per AVX2 register.
+//
+/*
+A hand_batch<LANES> stores its hands structure-of-arrays: suit[s][lane] is the 13-bit rank mask
+of suit s in hand 'lane' (the 16-bit lanes of card_set, widened to 32 bits). All the card_set
+predicates are then plain mask arithmetic on whole rows:
+
+- ranks   = s0 | s1 | s2 | s3, pairs (ranks held twice) and trips from the ANDs of suit pairs
+  and triples, quads = s0 & s1 & s2 & s3
+- flush: some suit with five or more bits (popcount by nibble lookup with vpshufb)
+- straight: m & m << 1 & ... & m << 4 is not zero, or m holds the A-2-3-4-5 wheel
+- "two or more bits" is (x & (x - 1)) != 0, so no popcount is needed for two pair or trips twice
+
+Each predicate becomes an all-ones / all-zero lane mask, and the category is the largest of
+(mask & category) over the predicates, since every predicate that holds means "at least this
+category". There is no branch on the cards anywhere.
+
+With AVX2 (x64 builds set /arch:AVX2) a batch is processed 8 lanes per instruction; without it
+the same arithmetic runs one lane at a time, so both give identical results. Any hand size from
+5 to 7 works; for 5-card hands flush and straight agree with is_flush / is_straight.
+*/
+#pragma once
+
+#include "Poker_CardSet.h"
+#include "Poker_Eval.h"
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Per-lane results of classify(): bit 'lane' of each mask, category per lane
+template <int LANES>
+struct batch_result {
+    uint32_t flush = 0;
+    uint32_t straight = 0;
+    uint32_t straight_flush = 0;
+    uint8_t category[LANES] = {};
+};
+
+template <int LANES>
+struct hand_batch {
+    static_assert(LANES % 8 == 0 && LANES <= 32, "lanes come in groups of 8, at most 32");
+
+    // Aligned on the stack; loads are unaligned since std::vector ignores the alignment before C++17
+    alignas(32) uint32_t suit[4][LANES];
+
+    hand_batch() { clear(); }
+
+    void clear() {
+        for (int s = 0; s < 4; ++s)
+            for (int l = 0; l < LANES; ++l)
+                suit[s][l] = 0;
+    }
+
+    void set(int lane, const card_set& h) {
+        for (int s = 0; s < 4; ++s)
+            suit[s][lane] = h.suit_mask(s);
+    }
+
+    card_set get(int lane) const {
+        uint64_t bits = 0;
+        for (int s = 0; s < 4; ++s)
+            bits |= static_cast<uint64_t>(suit[s][lane]) << (16 * s);
+        return card_set(bits);
+    }
+};
+
+namespace batch_detail {
+
+const uint32_t WHEEL = (1u << 12) | 0xF;
+
+// One lane of classify(), the scalar reference for the vector code
+inline int classify_lane(uint32_t a, uint32_t b, uint32_t c, uint32_t d, bool& flush, bool& straight) {
+    uint32_t ranks = a | b | c | d;
+    uint32_t pairs = (a & b) | (a & c) | (a & d) | (b & c) | (b & d) | (c & d);
+    uint32_t trips = (a & b & c) | (a & b & d) | (a & c & d) | (b & c & d);
+    uint32_t quads = a & b & c & d;
+
+    auto run = [](uint32_t m) { return (m & (m << 1) & (m << 2) & (m << 3) & (m << 4)) != 0 || (m & WHEEL) == WHEEL; };
+    flush = popcount64(a) >= 5 || popcount64(b) >= 5 || popcount64(c) >= 5 || popcount64(d) >= 5;
+    straight = run(ranks);
+    bool sf = run(a) || run(b) || run(c) || run(d);
+    bool full = trips != 0 && ((trips & (trips - 1)) != 0 || (pairs & ~trips) != 0);
+
+    int cat = 0;
+    cat = pairs ? 1 : cat;
+    cat = (pairs & (pairs - 1)) ? 2 : cat;
+    cat = trips ? 3 : cat;
+    cat = straight ? 4 : cat;
+    cat = flush ? 5 : cat;
+    cat = full ? 6 : cat;
+    cat = quads ? 7 : cat;
+    cat = sf ? 8 : cat;
+    return cat;
+}
+
+#if defined(__AVX2__)
+inline __m256i nonzero(__m256i x) {
+    return _mm256_xor_si256(_mm256_cmpeq_epi32(x, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+}
+
+// x has two or more bits set
+inline __m256i several(__m256i x) {
+    return nonzero(_mm256_and_si256(x, _mm256_sub_epi32(x, _mm256_set1_epi32(1))));
+}
+
+inline __m256i has_run(__m256i m) {
+    __m256i r = _mm256_and_si256(m, _mm256_slli_epi32(m, 1));
+    r = _mm256_and_si256(r, _mm256_slli_epi32(m, 2));
+    r = _mm256_and_si256(r, _mm256_slli_epi32(m, 3));
+    r = _mm256_and_si256(r, _mm256_slli_epi32(m, 4));
+    __m256i wheel = _mm256_set1_epi32(static_cast<int>(WHEEL));
+    return _mm256_or_si256(nonzero(r), _mm256_cmpeq_epi32(_mm256_and_si256(m, wheel), wheel));
+}
+
+// Suit with five or more cards: per-byte popcount by nibble lookup, then the two low bytes added
+inline __m256i five_or_more(__m256i m) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low4 = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(m, low4)),
+                                    _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi32(m, 4), low4)));
+    __m256i count = _mm256_and_si256(_mm256_add_epi32(bytes, _mm256_srli_epi32(bytes, 8)), _mm256_set1_epi32(0xFF));
+    return _mm256_cmpgt_epi32(count, _mm256_set1_epi32(4));
+}
+
+inline __m256i pick(__m256i cat, __m256i mask, int value) {
+    return _mm256_max_epi32(cat, _mm256_and_si256(mask, _mm256_set1_epi32(value)));
+}
+
+inline uint32_t lane_bits(__m256i mask) {
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+#endif
+
+} // namespace batch_detail
+
+// Classify every lane of 'batch'; unused lanes (no cards) come out as HIGH_CARD
+template <int LANES>
+inline void classify(const hand_batch<LANES>& batch, batch_result<LANES>& out) {
+    out.flush = out.straight = out.straight_flush = 0;
+#if defined(__AVX2__)
+    using namespace batch_detail;
+    for (int g = 0; g < LANES; g += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.suit[0][g]));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.suit[1][g]));
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.suit[2][g]));
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&batch.suit[3][g]));
+
+        __m256i ab = _mm256_and_si256(a, b), cd = _mm256_and_si256(c, d);
+        __m256i ranks = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        __m256i pairs = _mm256_or_si256(_mm256_or_si256(ab, cd),
+            _mm256_and_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)));
+        __m256i trips = _mm256_or_si256(_mm256_and_si256(ab, _mm256_or_si256(c, d)),
+                                        _mm256_and_si256(cd, _mm256_or_si256(a, b)));
+        __m256i quads = _mm256_and_si256(ab, cd);
+
+        __m256i flush = _mm256_or_si256(_mm256_or_si256(five_or_more(a), five_or_more(b)),
+                                        _mm256_or_si256(five_or_more(c), five_or_more(d)));
+        __m256i straight = has_run(ranks);
+        __m256i sf = _mm256_or_si256(_mm256_or_si256(has_run(a), has_run(b)),
+                                     _mm256_or_si256(has_run(c), has_run(d)));
+        __m256i full = _mm256_and_si256(nonzero(trips),
+            _mm256_or_si256(several(trips), nonzero(_mm256_andnot_si256(trips, pairs))));
+
+        __m256i cat = _mm256_and_si256(nonzero(pairs), _mm256_set1_epi32(1));
+        cat = pick(cat, several(pairs), 2);
+        cat = pick(cat, nonzero(trips), 3);
+        cat = pick(cat, straight, 4);
+        cat = pick(cat, flush, 5);
+        cat = pick(cat, full, 6);
+        cat = pick(cat, nonzero(quads), 7);
+        cat = pick(cat, sf, 8);
+
+        out.flush |= lane_bits(flush) << g;
+        out.straight |= lane_bits(straight) << g;
+        out.straight_flush |= lane_bits(sf) << g;
+
+        // Pack the eight 32-bit categories into bytes
+        __m128i lo = _mm256_castsi256_si128(cat), hi = _mm256_extracti128_si256(cat, 1);
+        __m128i bytes = _mm_packus_epi16(_mm_packus_epi32(lo, hi), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&out.category[g]), bytes);
+    }
+#else
+    for (int l = 0; l < LANES; ++l) {
+        bool flush, straight;
+        int cat = batch_detail::classify_lane(batch.suit[0][l], batch.suit[1][l], batch.suit[2][l], batch.suit[3][l],
+                                              flush, straight);
+        out.category[l] = static_cast<uint8_t>(cat);
+        out.flush |= static_cast<uint32_t>(flush) << l;
+        out.straight |= static_cast<uint32_t>(straight) << l;
+        out.straight_flush |= static_cast<uint32_t>(cat == 8) << l;
+    }
+#endif
+}
@@ -0,0 +1,149 @@
+// Poker_CardSet.h : A hand (or any set of cards) packed in one 64-bit word.
+//
+/*
+Bit 16 * suit + rank is set for every card in the set, with ranks deuce = 0 ... ace = 12 as in
+the evaluator. Each suit therefore owns a 16-bit lane holding its 13-bit rank mask, and the
+hand predicates become mask operations instead of copying, sorting and counting in a std::map:
+
+- flush: a suit mask with five or more bits
+- straight: five consecutive bits in the OR of the suit masks (plus the A-2-3-4-5 wheel)
+- multiples: a rank held in k suits is a bit set in the AND of k suit masks
+
+For a 5-card hand these give the same answers as is_flush / is_straight / is_4of_akind in
+Poker_Cards.h, and is_straight_flush() matches is_straight_flush_7 for 7-card hands.
+*/
+#pragma once
+
+#include "Poker_Cards.h"
+#include "Poker_Eval.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+class card_set {
+public:
+    card_set() : bits(0) {}
+    explicit card_set(uint64_t b) : bits(b) {}
+
+    explicit card_set(const std::vector<card>& hand) : bits(0) {
+        for (const auto& c : hand)
+            add(c);
+    }
+
+    // Bit of a card: 16 * suit + rank, ace high
+    static uint64_t bit(const card& c) {
+        int p = c.get_pips().get_pips();
+        return 1ULL << (16 * static_cast<int>(c.get_suit()) + (p == 1 ? 12 : p - 2));
+    }
+
+    // Bit of a card given by its deck index (suit * 13 + pips - 1, see card_index)
+    static uint64_t bit_of_index(int index) {
+        int p = index % 13 + 1;
+        return 1ULL << (16 * (index / 13) + (p == 1 ? 12 : p - 2));
+    }
+
+    // Inverse of bit(): the card stored at bit position 'pos'
+    static card card_at(int pos) {
+        int r = pos & 15;
+        return card(static_cast<suit>(pos >> 4), pips(r == 12 ? 1 : r + 2));
+    }
+
+    // Deck index (suit * 13 + pips - 1) of the card stored at bit position 'pos'
+    static int index_at(int pos) {
+        int r = pos & 15;
+        return 13 * (pos >> 4) + (r == 12 ? 0 : r + 1);
+    }
+
+    void add(const card& c) { bits |= bit(c); }
+    void add_index(int index) { bits |= bit_of_index(index); }
+    void remove(const card& c) { bits &= ~bit(c); }
+    bool contains(const card& c) const { return (bits & bit(c)) != 0; }
+    void clear() { bits = 0; }
+
+    uint64_t mask() const { return bits; }
+    int size() const { return popcount64(bits); }
+    bool empty() const { return bits == 0; }
+
+    card_set operator|(card_set o) const { return card_set(bits | o.bits); }
+    card_set operator&(card_set o) const { return card_set(bits & o.bits); }
+    bool operator==(card_set o) const { return bits == o.bits; }
+    bool operator!=(card_set o) const { return bits != o.bits; }
+
+    unsigned suit_mask(int s) const { return static_cast<unsigned>(bits >> (16 * s)) & 0x1FFF; }
+    unsigned suit_mask(suit s) const { return suit_mask(static_cast<int>(s)); }
+
+    // Ranks held in at least one, two, three or four suits
+    unsigned ranks() const {
+        return suit_mask(0) | suit_mask(1) | suit_mask(2) | suit_mask(3);
+    }
+    unsigned pairs_or_better() const {
+        unsigned a = suit_mask(0), b = suit_mask(1), c = suit_mask(2), d = suit_mask(3);
+        return (a & b) | (a & c) | (a & d) | (b & c) | (b & d) | (c & d);
+    }
+    unsigned trips_or_better() const {
+        unsigned a = suit_mask(0), b = suit_mask(1), c = suit_mask(2), d = suit_mask(3);
+        return (a & b & c) | (a & b & d) | (a & c & d) | (b & c & d);
+    }
+    unsigned quads() const {
+        return suit_mask(0) & suit_mask(1) & suit_mask(2) & suit_mask(3);
+    }
+
+    // Five consecutive ranks, the ace also counting as one
+    static bool has_straight(unsigned m) {
+        unsigned run = m & (m << 1) & (m << 2) & (m << 3) & (m << 4);
+        const unsigned wheel = (1u << 12) | 0xF;
+        return run != 0 || (m & wheel) == wheel;
+    }
+
+    bool is_flush() const {
+        for (int s = 0; s < 4; ++s)
+            if (popcount64(suit_mask(s)) >= 5)
+                return true;
+        return false;
+    }
+
+    bool is_straight() const { return has_straight(ranks()); }
+
+    bool is_straight_flush() const {
+        for (int s = 0; s < 4; ++s)
+            if (has_straight(suit_mask(s)))
+                return true;
+        return false;
+    }
+
+    bool is_4of_akind() const { return quads() != 0; }
+    bool is_3of_akind() const { return trips_or_better() != 0; }
+    bool is_full_house() const {
+        unsigned t = trips_or_better();
+        return t != 0 && (popcount64(t) >= 2 || (pairs_or_better() & ~t) != 0);
+    }
+    int pair_count() const { return popcount64(pairs_or_better()); }
+
+    // Best 5-card hand in the set (5 to 7 cards)
+    hand_rank evaluate() const {
+        const hand_evaluator& e = hand_evaluator::instance();
+        uint64_t key = 0;
+        for (uint64_t b = bits; b; b &= b - 1)
+            key += e.key_of(index_at(lowest_bit(b)));
+        return e.evaluate_key(key, bits);
+    }
+
+    hand_category category() const { return hand_evaluator::category(evaluate()); }
+
+    std::vector<card> to_cards() const {
+        std::vector<card> hand;
+        for (uint64_t b = bits; b; b &= b - 1)
+            hand.push_back(card_at(lowest_bit(b)));
+        return hand;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const card_set& h) {
+        for (uint64_t b = h.bits; b; b &= b - 1)
+            out << card_at(lowest_bit(b)) << " ";
+        return out;
+    }
+
+private:
+    uint64_t bits;
+};
@@ -0,0 +1,174 @@
+// Poker_Enumeration.h : Exact hand-category counts over every 5- to 7-card combination.
+//
+/*
+There are only C(52, 5) = 2,598,960 five-card and C(52, 7) = 133,784,560 seven-card hands, so
+the frequencies the shuffle loop samples can be counted exactly by visiting each one once.
+
+Hands are numbered with the combinatorial number system: a hand with cards c1 < c2 < ... < ck
+has index C(c1, 1) + C(c2, 2) + ... + C(ck, k), which maps the hands one-to-one onto
+0 .. C(52, k) - 1 (see combination_index / combination_at). In that order all hands whose
+highest card is c form the contiguous block [C(c, k), C(c + 1, k)), so the work is split by
+that card: threads take the next block from an atomic counter, highest card first, because
+the blocks grow quickly with c.
+
+Every hand is classified twice:
+- by the predicates of the shuffle loop (is_flush, is_straight, is_straight_flush with the
+  7-card semantics of is_straight_flush_7, is_4of_akind, ...) on the packed card_set, and
+- by the table evaluator in Poker_Eval.h.
+The first gives the reference counts; any hand on which the two disagree is counted and the
+first one found is kept, so the run doubles as a correctness oracle for the fast evaluator.
+*/
+#pragma once
+
+#include "Poker_CardSet.h"
+#include "Poker_Eval.h"
+#include "Poker_Simulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// C(n, k) for 0 <= n <= 52, 0 <= k <= 7
+inline uint64_t binomial(int n, int k) {
+    struct table {
+        uint64_t c[53][8];
+        table() {
+            for (int i = 0; i <= 52; ++i) {
+                c[i][0] = 1;
+                for (int j = 1; j < 8; ++j)
+                    c[i][j] = i == 0 ? 0 : c[i - 1][j - 1] + c[i - 1][j];
+            }
+        }
+    };
+    static const table t;
+    return (n < 0 || k < 0 || k > 7) ? 0 : t.c[n][k];
+}
+
+// Index of a hand in the combinatorial number system; 'cards' sorted ascending
+inline uint64_t combination_index(const int* cards, int k) {
+    uint64_t index = 0;
+    for (int i = 0; i < k; ++i)
+        index += binomial(cards[i], i + 1);
+    return index;
+}
+
+// Inverse of combination_index: the k cards (ascending) of hand number 'index'
+inline void combination_at(uint64_t index, int k, int* cards) {
+    int c = 51;
+    for (int i = k; i >= 1; --i) {
+        while (binomial(c, i) > index)
+            --c;
+        cards[i - 1] = c;
+        index -= binomial(c, i);
+        --c;
+    }
+}
+
+// Category from the card_set predicates alone, independent of the evaluator tables
+inline hand_category predicate_category(const card_set& h) {
+    if (h.is_straight_flush()) return hand_category::STRAIGHT_FLUSH;
+    if (h.is_4of_akind()) return hand_category::FOUR_OF_A_KIND;
+    if (h.is_full_house()) return hand_category::FULL_HOUSE;
+    if (h.is_flush()) return hand_category::FLUSH;
+    if (h.is_straight()) return hand_category::STRAIGHT;
+    if (h.is_3of_akind()) return hand_category::THREE_OF_A_KIND;
+    int pairs = h.pair_count();
+    if (pairs >= 2) return hand_category::TWO_PAIR;
+    if (pairs == 1) return hand_category::PAIR;
+    return hand_category::HIGH_CARD;
+}
+
+struct enumeration_result {
+    category_counts counts;         // exclusive categories, from the predicates
+    uint64_t flushes = 0;           // shuffle-loop counters: a straight flush also counts as
+    uint64_t straights = 0;         // a flush and as a straight
+    uint64_t straight_flushes = 0;
+    uint64_t mismatches = 0;        // hands the evaluator puts in another category
+    uint64_t first_mismatch = 0;    // combination index of the lowest one
+    double seconds = 0.0;
+    int threads = 0;
+
+    double hands_per_second() const { return seconds > 0.0 ? counts.trials / seconds : 0.0; }
+};
+
+namespace enumeration_detail {
+
+struct tally {
+    uint64_t count[9] = {};
+    uint64_t flushes = 0, straights = 0, straight_flushes = 0;
+    uint64_t hands = 0, mismatches = 0;
+    uint64_t first_mismatch = ~0ULL;
+};
+
+// Visit every way of adding 'remaining' cards below 'top' to the partial hand (cards[0..k))
+inline void visit(const hand_evaluator& e, int* cards, int k, int remaining, int top,
+                  uint64_t key, uint64_t bits, tally& t) {
+    if (remaining == 0) {
+        card_set h(bits);
+        hand_category c = predicate_category(h);
+        ++t.count[static_cast<int>(c)];
+        t.flushes += h.is_flush();
+        t.straights += h.is_straight();
+        t.straight_flushes += c == hand_category::STRAIGHT_FLUSH;
+        ++t.hands;
+        if (e.category_of(e.evaluate_key(key, bits)) != c) {
+            int sorted[7];
+            std::reverse_copy(cards, cards + k, sorted);
+            t.first_mismatch = std::min(t.first_mismatch, combination_index(sorted, k));
+            ++t.mismatches;
+        }
+        return;
+    }
+    for (int c = top - 1; c >= remaining - 1; --c) {
+        cards[k] = c;
+        visit(e, cards, k + 1, remaining - 1, c, key + e.key_of(c), bits | card_set::bit_of_index(c), t);
+    }
+}
+
+} // namespace enumeration_detail
+
+// Count the categories of all C(52, cards) hands, 5 <= cards <= 7
+inline enumeration_result enumerate_hands(int cards, int threads = 0) {
+    enumeration_result result;
+    int n_threads = threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    result.threads = n_threads;
+
+    const hand_evaluator& e = hand_evaluator::instance();
+    std::vector<enumeration_detail::tally> partial(n_threads);
+    std::atomic<int> next_top(51);
+
+    auto worker = [&](enumeration_detail::tally& t) {
+        int hand[7];
+        for (int top = next_top--; top >= cards - 1; top = next_top--) {
+            hand[0] = top;
+            enumeration_detail::visit(e, hand, 1, cards - 1, top, e.key_of(top), card_set::bit_of_index(top), t);
+        }
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 1; t < n_threads; ++t)
+        pool.emplace_back(worker, std::ref(partial[t]));
+    worker(partial[0]);
+    for (auto& th : pool)
+        th.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    result.first_mismatch = ~0ULL;
+    for (const auto& t : partial) {
+        for (int c = 0; c < 9; ++c)
+            result.counts.count[c] += t.count[c];
+        result.counts.trials += t.hands;
+        result.flushes += t.flushes;
+        result.straights += t.straights;
+        result.straight_flushes += t.straight_flushes;
+        result.mismatches += t.mismatches;
+        result.first_mismatch = std::min(result.first_mismatch, t.first_mismatch);
+    }
+    if (result.mismatches == 0)
+        result.first_mismatch = 0;
+    return result;
+}
@@ -0,0 +1,301 @@
+// Poker_Equity.h : Texas Hold'em equity of two or more hands for a partial (or empty) board.
+//
+/*
+Each player holds two cards; the board has 0 to 5 known cards and the rest is dealt from the
+remaining deck. A board is worth 1 to the single best hand, or 1/k to each of k tied hands, and
+a player's equity is the average over all boards.
+
+- Exhaustive: when the number of boards C(remaining, missing) is at most max_exhaustive, every
+  board is visited once (split by highest card over the threads, as in Poker_Enumeration.h) and
+  the equities are exact. Flop and turn spots always qualify; heads-up preflop is
+  C(48, 5) = 1,712,304 boards, about what Monte Carlo needs for a standard error of 4e-4, so with
+  the default max_exhaustive of 1,000,000 preflop spots are simulated (raise it to enumerate them).
+- Monte Carlo: otherwise each thread draws boards with its own xoshiro256** stream and a partial
+  Fisher-Yates shuffle of the remaining deck. Every 'batch' boards a thread adds its sums of
+  x and x^2 (x = the player's share of the board) to the shared totals under a lock and checks
+  the standard error sqrt(var / n) of every player; all threads stop as soon as the largest one
+  is at most target_stderr, or after max_boards.
+
+The hole and known board cards are summed into evaluator keys once, so scoring a board costs
+one key addition and one table lookup per player.
+
+compute_equity throws std::invalid_argument for fewer than two hands, a hand that is not two
+cards, more than 5 board cards, a card given twice, or too few cards left to complete the board
+(more than 23 players).
+*/
+#pragma once
+
+#include "Poker_CardSet.h"
+#include "Poker_Enumeration.h"
+#include "Poker_Eval.h"
+#include "Poker_Simulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct equity_config {
+    std::vector<std::vector<int>> hands;    // two card indices per player (see card_index)
+    std::vector<int> board;                 // 0 to 5 known board cards
+    int threads = 0;                        // 0 = one per hardware thread
+    uint64_t max_exhaustive = 1000000;      // largest board count enumerated exactly
+    double target_stderr = 0.0005;          // Monte Carlo stops once every player is this precise
+    uint64_t max_boards = 200000000;        // ... or after this many boards
+    uint64_t batch = 16384;                 // boards a thread simulates between checks
+    uint64_t seed = 1;
+};
+
+struct player_equity {
+    double equity = 0.0;            // expected share of the pot
+    double win = 0.0;               // fraction of boards won outright
+    double tie = 0.0;               // fraction of boards split
+    double std_error = 0.0;         // standard error of 'equity' (0 when exhaustive)
+};
+
+struct equity_result {
+    std::vector<player_equity> players;
+    uint64_t boards = 0;
+    bool exhaustive = false;
+    double seconds = 0.0;
+    int threads = 0;
+
+    double boards_per_second() const { return seconds > 0.0 ? boards / seconds : 0.0; }
+};
+
+// Parse cards written as rank + suit, e.g. "As Td 9c" or "AsTd9c" (ranks A K Q J T 9..2,
+// suits s h d c, either case). Returns false on malformed input.
+inline bool parse_cards(const std::string& text, std::vector<int>& out) {
+    const std::string ranks = "A23456789TJQK";  // pips 1..13
+    const std::string suits = "SHDC";           // suit enum order
+    for (size_t i = 0; i < text.size();) {
+        if (text[i] == ' ' || text[i] == ',') {
+            ++i;
+            continue;
+        }
+        if (i + 1 >= text.size())
+            return false;
+        size_t r = ranks.find(static_cast<char>(std::toupper(static_cast<unsigned char>(text[i]))));
+        size_t s = suits.find(static_cast<char>(std::toupper(static_cast<unsigned char>(text[i + 1]))));
+        if (r == std::string::npos || s == std::string::npos)
+            return false;
+        out.push_back(static_cast<int>(s * 13 + r));
+        i += 2;
+    }
+    return true;
+}
+
+namespace equity_detail {
+
+// Per-thread totals; x is a player's share of one board
+struct tally {
+    std::vector<double> sum, sum_sq;
+    std::vector<uint64_t> wins, ties;
+    uint64_t boards = 0;
+
+    explicit tally(size_t players = 0) : sum(players), sum_sq(players), wins(players), ties(players) {}
+
+    void merge(const tally& o) {
+        for (size_t p = 0; p < sum.size(); ++p) {
+            sum[p] += o.sum[p];
+            sum_sq[p] += o.sum_sq[p];
+            wins[p] += o.wins[p];
+            ties[p] += o.ties[p];
+        }
+        boards += o.boards;
+    }
+};
+
+class scorer {
+public:
+    scorer(const equity_config& cfg) : e(hand_evaluator::instance()) {
+        uint64_t board_key = 0, board_bits = 0;
+        for (int c : cfg.board) {
+            board_key += e.key_of(c);
+            board_bits |= e.bit_of(c);
+        }
+        for (const auto& h : cfg.hands) {
+            key.push_back(board_key + e.key_of(h[0]) + e.key_of(h[1]));
+            bits.push_back(board_bits | e.bit_of(h[0]) | e.bit_of(h[1]));
+        }
+        rank.resize(cfg.hands.size());
+    }
+
+    // Score one completion of the board, given as the sum of its keys and the OR of its bits
+    void score(uint64_t k, uint64_t b, tally& t) {
+        hand_rank best = 0;
+        int winners = 0;
+        for (size_t p = 0; p < key.size(); ++p) {
+            rank[p] = e.evaluate_key(key[p] + k, bits[p] | b);
+            if (rank[p] > best) {
+                best = rank[p];
+                winners = 1;
+            }
+            else if (rank[p] == best)
+                ++winners;
+        }
+        double share = 1.0 / winners;
+        for (size_t p = 0; p < key.size(); ++p) {
+            if (rank[p] != best)
+                continue;
+            t.sum[p] += share;
+            t.sum_sq[p] += share * share;
+            ++(winners == 1 ? t.wins[p] : t.ties[p]);
+        }
+        ++t.boards;
+    }
+
+    const hand_evaluator& e;
+
+private:
+    std::vector<uint64_t> key, bits;
+    std::vector<hand_rank> rank;
+};
+
+// Every way of adding 'remaining' cards from rest[0..top) to the partial board
+inline void visit(scorer& s, const std::vector<int>& rest, int remaining, int top,
+                  uint64_t key, uint64_t bits, tally& t) {
+    if (remaining == 0) {
+        s.score(key, bits, t);
+        return;
+    }
+    for (int i = top - 1; i >= remaining - 1; --i) {
+        int c = rest[i];
+        visit(s, rest, remaining - 1, i, key + s.e.key_of(c), bits | s.e.bit_of(c), t);
+    }
+}
+
+} // namespace equity_detail
+
+// Equity of every hand in cfg.hands; the cards must all be distinct
+inline equity_result compute_equity(const equity_config& cfg) {
+    using equity_detail::tally;
+    const size_t players = cfg.hands.size();
+    const int missing = 5 - static_cast<int>(cfg.board.size());
+    if (players < 2)
+        throw std::invalid_argument("compute_equity: need at least two hands");
+    if (missing < 0)
+        throw std::invalid_argument("compute_equity: the board has more than 5 cards");
+
+    card_set used;
+    size_t n_cards = cfg.board.size();
+    auto add = [&](int c) {
+        if (c < 0 || c >= 52)
+            throw std::invalid_argument("compute_equity: card index out of range");
+        used.add_index(c);
+    };
+    for (const auto& h : cfg.hands) {
+        if (h.size() != 2)
+            throw std::invalid_argument("compute_equity: every hand needs two cards");
+        n_cards += h.size();
+        for (int c : h)
+            add(c);
+    }
+    for (int c : cfg.board)
+        add(c);
+    if (static_cast<size_t>(used.size()) != n_cards)
+        throw std::invalid_argument("compute_equity: a card is given twice");
+    if (52 - static_cast<int>(n_cards) < missing)
+        throw std::invalid_argument("compute_equity: too few cards left to complete the board");
+    std::vector<int> rest;
+    for (int c = 0; c < 52; ++c)
+        if ((used.mask() & card_set::bit_of_index(c)) == 0)
+            rest.push_back(c);
+    const int n_rest = static_cast<int>(rest.size());
+
+    equity_result result;
+    result.threads = cfg.threads > 0 ? cfg.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    result.exhaustive = binomial(n_rest, missing) <= cfg.max_exhaustive;
+    if (missing == 0)
+        result.threads = 1; // a single board to score
+
+    hand_evaluator::instance();
+    tally total(players);
+    std::mutex total_lock;
+    std::atomic<bool> done(false);
+    std::atomic<int> next_top(n_rest - 1);
+    xoshiro256ss stream(cfg.seed);
+
+    // Largest standard error over the players, from the shared totals (caller holds the lock)
+    auto worst_stderr = [&]() {
+        double worst = 0.0;
+        double n = static_cast<double>(total.boards);
+        for (size_t p = 0; p < players; ++p) {
+            double mean = total.sum[p] / n;
+            double var = std::max(0.0, total.sum_sq[p] / n - mean * mean);
+            worst = std::max(worst, std::sqrt(var / n));
+        }
+        return worst;
+    };
+
+    auto exhaustive_worker = [&]() {
+        equity_detail::scorer s(cfg);
+        tally t(players);
+        if (missing == 0)
+            s.score(0, 0, t);
+        else
+            for (int top = next_top--; top >= missing - 1; top = next_top--) {
+                int c = rest[top];
+                equity_detail::visit(s, rest, missing - 1, top, s.e.key_of(c), s.e.bit_of(c), t);
+            }
+        std::lock_guard<std::mutex> lock(total_lock);
+        total.merge(t);
+    };
+
+    auto monte_carlo_worker = [&](xoshiro256ss rng) {
+        equity_detail::scorer s(cfg);
+        std::vector<int> deck(rest);
+        while (!done) {
+            tally t(players);
+            for (uint64_t i = 0; i < cfg.batch; ++i) {
+                uint64_t key = 0, bits = 0;
+                for (int j = 0; j < missing; ++j) {
+                    int k = j + static_cast<int>(bounded_rand(rng, static_cast<uint32_t>(n_rest - j)));
+                    std::swap(deck[j], deck[k]);
+                    key += s.e.key_of(deck[j]);
+                    bits |= s.e.bit_of(deck[j]);
+                }
+                s.score(key, bits, t);
+            }
+            std::lock_guard<std::mutex> lock(total_lock);
+            if (done)
+                break;
+            total.merge(t);
+            if (total.boards >= cfg.max_boards || worst_stderr() <= cfg.target_stderr)
+                done = true;
+        }
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < result.threads; ++t) {
+        if (result.exhaustive)
+            pool.emplace_back(exhaustive_worker);
+        else
+            pool.emplace_back(monte_carlo_worker, stream);
+        stream.jump();
+    }
+    for (auto& th : pool)
+        th.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    result.boards = total.boards;
+    double n = static_cast<double>(total.boards);
+    for (size_t p = 0; p < players; ++p) {
+        player_equity pe;
+        pe.equity = total.sum[p] / n;
+        pe.win = total.wins[p] / n;
+        pe.tie = total.ties[p] / n;
+        if (!result.exhaustive)
+            pe.std_error = std::sqrt(std::max(0.0, total.sum_sq[p] / n - pe.equity * pe.equity) / n);
+        result.players.push_back(pe);
+    }
+    return result;
+}
@@ -0,0 +1,385 @@
+// Poker_Eval.h : Table-driven poker hand evaluator for 5, 6 and 7 cards.
+//
+/*
+Every poker hand falls in one of 7462 equivalence classes (e.g. all "A-K-Q-J-9 of one suit" flushes
+are equal). The evaluator returns the class as a hand_rank from 1 (7-5-4-3-2 unsuited) to 7462
+(royal flush), so two hands compare with a plain integer comparison.
+
+Tables, built once on first use (a few milliseconds):
+- flush_rank[8192]: indexed by the 13-bit rank mask of a suit holding five or more cards.
+  With at most seven cards a flush always beats whatever the off-suit cards could make,
+  so a flush hand is decided by this single lookup.
+- no_flush_rank: indexed by a perfect hash of the rank counts (how many 2s, 3s, ..., As).
+  The hash ranks the count vector among all vectors of n cards with at most four per rank
+  (6175 for n = 5, 18395 for n = 6, 49205 for n = 7), so the table has no holes.
+  Ranking rank by rank, the part contributed by ranks r..12 only depends on their own counts
+  and on how many cards they hold, so the ranks are split in three groups (2-5, 6-T, J-A) whose
+  contributions are precomputed in low/mid/high tables indexed by the counts written in base 5.
+
+Each card has a precomputed 64-bit key holding its base-5 digit for its group, +1 to the card
+counters the group tables need, and +1 to its suit counter (one nibble per suit, bits 48-63).
+Adding the keys of the cards in a hand gives the three table indices and the suit counts in one
+go; adding 3 to every suit nibble sets its top bit only for a suit with five or more cards.
+The suit masks come from OR-ing one bit per card (bit suit * 16 + rank).
+
+Evaluating a hand is one pass of adds and ORs over the cards and three or four table lookups:
+no branches per card, no sorting, nothing allocated.
+Cards are numbered 0..51 in deck order (suit * 13 + pips - 1), see card_index().
+*/
+#pragma once
+
+#include "Poker_Cards.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+enum class hand_category {
+    HIGH_CARD, PAIR, TWO_PAIR, THREE_OF_A_KIND, STRAIGHT,
+    FLUSH, FULL_HOUSE, FOUR_OF_A_KIND, STRAIGHT_FLUSH
+};
+
+inline const char* category_name(hand_category c) {
+    static const char* names[] = {
+        "High Card", "Pair", "Two Pair", "Three of a Kind", "Straight",
+        "Flush", "Full House", "Four of a Kind", "Straight Flush"
+    };
+    return names[static_cast<int>(c)];
+}
+
+using hand_rank = uint16_t;   // 1..7462, higher is better
+
+// Position of a card in a deck filled by init_deck()
+inline int card_index(const card& c) {
+    return static_cast<int>(c.get_suit()) * 13 + c.get_pips().get_pips() - 1;
+}
+
+// Evaluator ranks: deuce = 0 ... king = 11, ace = 12
+inline int eval_rank(int index) {
+    int p = index % 13;           // pips - 1: ace = 0, deuce = 1, ..., king = 12
+    return p == 0 ? 12 : p - 1;
+}
+
+inline int eval_suit(int index) { return index / 13; }
+
+inline int popcount64(uint64_t m) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(m));
+#elif defined(__GNUC__)
+    return __builtin_popcountll(m);
+#else
+    int n = 0;
+    for (; m; m &= m - 1)
+        ++n;
+    return n;
+#endif
+}
+
+// Index of the lowest set bit; 'm' must not be zero
+inline int lowest_bit(uint64_t m) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, m);
+    return static_cast<int>(i);
+#elif defined(__GNUC__)
+    return __builtin_ctzll(m);
+#else
+    int i = 0;
+    while (!(m & 1)) {
+        m >>= 1;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+class hand_evaluator {
+public:
+    static const int CLASSES = 7462;
+
+    // Tables are shared and read-only after construction (thread-safe static initialisation)
+    static const hand_evaluator& instance() {
+        static const hand_evaluator e;
+        return e;
+    }
+
+    // Best hand that can be made from 'n' cards (5 <= n <= 7), given as indices 0..51
+    hand_rank evaluate(const int* cards, int n) const {
+        uint64_t key = 0, bits = 0;
+        for (int i = 0; i < n; ++i) {
+            key += card_key[cards[i]];
+            bits |= card_bit[cards[i]];
+        }
+        return evaluate_key(key, bits);
+    }
+
+    hand_rank evaluate5(int a, int b, int c, int d, int e) const {
+        return evaluate_key(card_key[a] + card_key[b] + card_key[c] + card_key[d] + card_key[e],
+            card_bit[a] | card_bit[b] | card_bit[c] | card_bit[d] | card_bit[e]);
+    }
+
+    hand_rank evaluate7(int a, int b, int c, int d, int e, int f, int g) const {
+        return evaluate_key(
+            card_key[a] + card_key[b] + card_key[c] + card_key[d] + card_key[e] + card_key[f] + card_key[g],
+            card_bit[a] | card_bit[b] | card_bit[c] | card_bit[d] | card_bit[e] | card_bit[f] | card_bit[g]);
+    }
+
+    // Lowest level entry point: sum of card_key and OR of card_bit over the cards of the hand.
+    // Callers that build hands incrementally (e.g. a shared board plus hole cards) can keep partial sums.
+    hand_rank evaluate_key(uint64_t key, uint64_t bits) const {
+        uint64_t flush = ((key >> 48) + 0x3333) & 0x8888;
+        if (flush) {
+            int s = lowest_bit(flush) >> 2;
+            return flush_rank[(bits >> (16 * s)) & 0x1FFF];
+        }
+        return no_flush_rank[low_table[key & 0xFFFF] + mid_table[(key >> 16) & 0xFFFF] + high_table[(key >> 32) & 0xFFFF]];
+    }
+
+    uint64_t key_of(int card) const { return card_key[card]; }
+    uint64_t bit_of(int card) const { return card_bit[card]; }
+
+    static hand_category category(hand_rank r) {
+        return instance().category_of(r);
+    }
+
+    // Same as category() without going through instance(), for hot loops holding a reference
+    hand_category category_of(hand_rank r) const {
+        return static_cast<hand_category>(category_table[r]);
+    }
+
+private:
+    // Rank groups of the perfect hash: low = deuce..five, mid = six..ten, high = jack..ace
+    static const int LOW_RANKS = 4, MID_RANKS = 5, HIGH_RANKS = 4;
+    static const int POW5_LOW = 625, POW5_MID = 3125, POW5_HIGH = 625;
+
+    uint64_t card_key[52];
+    uint64_t card_bit[52];
+    hand_rank flush_rank[8192];
+    uint32_t low_table[8 * POW5_LOW];      // [cards in hand][low digits], includes the block offset for that n
+    uint16_t mid_table[8 * POW5_MID];      // [cards in mid + high groups][mid digits]
+    uint16_t high_table[POW5_HIGH];        // [high digits]
+    std::vector<hand_rank> no_flush_rank;  // blocks for n = 5, 6, 7 one after the other
+    uint8_t category_table[CLASSES + 1];
+
+    // Highest card of a straight contained in 'mask' (3 for the A-2-3-4-5 wheel), or -1
+    static int straight_high(unsigned mask) {
+        for (int h = 12; h >= 4; --h) {
+            unsigned run = 0x1Fu << (h - 4);
+            if ((mask & run) == run)
+                return h;
+        }
+        const unsigned wheel = (1u << 12) | 0xF;
+        return (mask & wheel) == wheel ? 3 : -1;
+    }
+
+    // Sortable value of a hand: category in bits 20+, then up to five ranks of 4 bits each
+    static uint32_t make_value(hand_category c, const int* ranks, int n) {
+        uint32_t v = static_cast<uint32_t>(c);
+        for (int i = 0; i < 5; ++i)
+            v = (v << 4) | static_cast<uint32_t>(i < n ? ranks[i] : 0);
+        return v;
+    }
+
+    static uint32_t flush_value(unsigned mask) {
+        int high = straight_high(mask);
+        if (high >= 0)
+            return make_value(hand_category::STRAIGHT_FLUSH, &high, 1);
+        int ranks[5], n = 0;
+        for (int r = 12; r >= 0 && n < 5; --r)
+            if (mask & (1u << r))
+                ranks[n++] = r;
+        return make_value(hand_category::FLUSH, ranks, 5);
+    }
+
+    // Best hand from rank counts alone (no five cards share a suit)
+    static uint32_t no_flush_value(const uint8_t counts[13]) {
+        int quads = -1, trips[2] = { -1, -1 }, pairs[3] = { -1, -1, -1 };
+        int nt = 0, np = 0;
+        unsigned mask = 0;
+        for (int r = 12; r >= 0; --r) {
+            if (counts[r] == 0) continue;
+            mask |= 1u << r;
+            if (counts[r] == 4) quads = r;
+            else if (counts[r] == 3) trips[nt++] = r;
+            else if (counts[r] == 2) pairs[np++] = r;
+        }
+        // Highest ranks present, skipping the ones already used
+        auto kickers = [&](int* out, int want, int skip1, int skip2) {
+            int n = 0;
+            for (int r = 12; r >= 0 && n < want; --r)
+                if ((mask & (1u << r)) && r != skip1 && r != skip2)
+                    out[n++] = r;
+        };
+        int ranks[5];
+        if (quads >= 0) {
+            ranks[0] = quads;
+            kickers(ranks + 1, 1, quads, -1);
+            return make_value(hand_category::FOUR_OF_A_KIND, ranks, 2);
+        }
+        if (nt > 0 && (nt > 1 || np > 0)) {
+            ranks[0] = trips[0];
+            ranks[1] = nt > 1 ? std::max(trips[1], pairs[0]) : pairs[0];
+            return make_value(hand_category::FULL_HOUSE, ranks, 2);
+        }
+        int high = straight_high(mask);
+        if (high >= 0)
+            return make_value(hand_category::STRAIGHT, &high, 1);
+        if (nt > 0) {
+            ranks[0] = trips[0];
+            kickers(ranks + 1, 2, trips[0], -1);
+            return make_value(hand_category::THREE_OF_A_KIND, ranks, 3);
+        }
+        if (np >= 2) {
+            ranks[0] = pairs[0];
+            ranks[1] = pairs[1];
+            kickers(ranks + 2, 1, pairs[0], pairs[1]);
+            return make_value(hand_category::TWO_PAIR, ranks, 3);
+        }
+        if (np == 1) {
+            ranks[0] = pairs[0];
+            kickers(ranks + 1, 3, pairs[0], -1);
+            return make_value(hand_category::PAIR, ranks, 4);
+        }
+        kickers(ranks, 5, -1, -1);
+        return make_value(hand_category::HIGH_CARD, ranks, 5);
+    }
+
+    // Calls f(counts) for every way of spreading n cards over ranks r..12
+    template <class F>
+    static void for_each_counts(uint8_t* counts, int r, int n, F& f) {
+        if (r == 12) {
+            if (n <= 4) {
+                counts[12] = static_cast<uint8_t>(n);
+                f(counts);
+            }
+            return;
+        }
+        for (int c = 0; c <= 4 && c <= n; ++c) {
+            counts[r] = static_cast<uint8_t>(c);
+            for_each_counts(counts, r + 1, n - c, f);
+        }
+    }
+
+    hand_evaluator() {
+        // ways[r][k]: number of ways to put k cards on ranks r..12, at most four each
+        int ways[14][8] = {};
+        ways[13][0] = 1;
+        for (int r = 12; r >= 0; --r)
+            for (int k = 0; k <= 7; ++k)
+                for (int c = 0; c <= 4 && c <= k; ++c)
+                    ways[r][k] += ways[r + 1][k - c];
+
+        // offset[r][k][c]: count vectors placed before the ones with c cards of rank r, when k cards
+        // are left for ranks r..12. The index of a count vector is the sum of its offsets.
+        int offset[13][8][5] = {};
+        for (int r = 0; r < 13; ++r)
+            for (int k = 0; k <= 7; ++k)
+                for (int c = 1; c <= 4; ++c)
+                    offset[r][k][c] = offset[r][k][c - 1] + (c - 1 <= k ? ways[r + 1][k - (c - 1)] : 0);
+
+        int block_start[8] = {};
+        for (int n = 5, start = 0; n <= 7; ++n) {
+            block_start[n] = start;
+            start += ways[0][n];
+        }
+
+        // Group tables: every combination of base-5 digits, the sum of the offsets of its ranks
+        auto group_sum = [&](int first, int ranks, int k, int code, bool& valid) {
+            int sum = 0;
+            for (int r = first; r < first + ranks; ++r, code /= 5) {
+                int c = code % 5;
+                if (c > k) {
+                    valid = false;
+                    return 0;
+                }
+                sum += offset[r][k][c];
+                k -= c;
+            }
+            return sum;
+        };
+        for (int n = 0; n < 8; ++n) {
+            for (int code = 0; code < POW5_LOW; ++code) {
+                bool valid = true;
+                int v = group_sum(0, LOW_RANKS, n, code, valid) + block_start[n];
+                low_table[n * POW5_LOW + code] = static_cast<uint32_t>(valid && n >= 5 ? v : 0);
+            }
+        }
+        for (int k = 0; k < 8; ++k) {
+            for (int code = 0; code < POW5_MID; ++code) {
+                bool valid = true;
+                int v = group_sum(LOW_RANKS, MID_RANKS, k, code, valid);
+                mid_table[k * POW5_MID + code] = static_cast<uint16_t>(valid ? v : 0);
+            }
+        }
+        for (int code = 0; code < POW5_HIGH; ++code) {
+            bool valid = true;
+            int k = 0;
+            for (int c = code; c; c /= 5)
+                k += c % 5;
+            int v = k <= 7 ? group_sum(LOW_RANKS + MID_RANKS, HIGH_RANKS, k, code, valid) : 0;
+            high_table[code] = static_cast<uint16_t>(valid ? v : 0);
+        }
+
+        // Per-card keys: group digit, card counters (low field counts every card, mid field
+        // counts the cards of the mid and high groups) and suit counter
+        const int pow5[5] = { 1, 5, 25, 125, 625 };
+        for (int i = 0; i < 52; ++i) {
+            int r = eval_rank(i), s = eval_suit(i);
+            uint64_t low = POW5_LOW + (r < LOW_RANKS ? pow5[r] : 0);
+            uint64_t mid = r < LOW_RANKS ? 0 : POW5_MID + (r < LOW_RANKS + MID_RANKS ? pow5[r - LOW_RANKS] : 0);
+            uint64_t high = r < LOW_RANKS + MID_RANKS ? 0 : pow5[r - LOW_RANKS - MID_RANKS];
+            card_key[i] = low | (mid << 16) | (high << 32) | (1ULL << (48 + 4 * s));
+            card_bit[i] = 1ULL << (16 * s + r);
+        }
+
+        // The 7462 distinct 5-card values, sorted, give the final ranks
+        std::vector<uint32_t> values;
+        for (unsigned m = 0; m < 8192; ++m)
+            if (popcount64(m) == 5)
+                values.push_back(flush_value(m));
+        uint8_t counts[13] = {};
+        auto collect = [&](const uint8_t* c) { values.push_back(no_flush_value(c)); };
+        for_each_counts(counts, 0, 5, collect);
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        auto to_rank = [&](uint32_t v) {
+            return static_cast<hand_rank>(std::lower_bound(values.begin(), values.end(), v) - values.begin() + 1);
+        };
+
+        category_table[0] = 0;
+        for (size_t i = 0; i < values.size(); ++i)
+            category_table[i + 1] = static_cast<uint8_t>(values[i] >> 20);
+
+        for (unsigned m = 0; m < 8192; ++m)
+            flush_rank[m] = popcount64(m) >= 5 ? to_rank(flush_value(m)) : 0;
+
+        no_flush_rank.assign(block_start[7] + ways[0][7], 0);
+        for (int n = 5; n <= 7; ++n) {
+            auto fill = [&](const uint8_t* c) {
+                int idx = block_start[n];
+                for (int r = 0, k = n; r < 13; k -= c[r], ++r)
+                    idx += offset[r][k][c[r]];
+                no_flush_rank[idx] = to_rank(no_flush_value(c));
+            };
+            for_each_counts(counts, 0, n, fill);
+        }
+    }
+};
+
+// Convenience wrapper for the card class: best hand in a 5 to 7 card hand; throws
+// std::invalid_argument for any other number of cards
+inline hand_rank evaluate_hand(const std::vector<card>& hand) {
+    if (hand.size() < 5 || hand.size() > 7)
+        throw std::invalid_argument("evaluate_hand: a hand needs 5 to 7 cards");
+    int cards[7];
+    int n = static_cast<int>(hand.size());
+    for (int i = 0; i < n; ++i)
+        cards[i] = card_index(hand[i]);
+    return hand_evaluator::instance().evaluate(cards, n);
+}
@@ -0,0 +1,539 @@
+// Hex_AlphaBeta.h : Alpha-Beta search for Hex.
+//
+/*
+Negamax search with alpha-beta pruning over the Hex board model in Hex_Board.h.
+
+- Iterative deepening: depth 1, 2, ... until the depth or time limit is reached; the best move of
+  the last completed iteration is returned and is searched first in the next one.
+- Move ordering: transposition table move, then two killer moves per ply, then history heuristic
+  (with a small bias towards the centre of the board to break ties on empty positions).
+- Transposition table: Zobrist hashing (one 64-bit key per cell and colour, plus a side-to-move key),
+  fixed size given in megabytes. A new result replaces whatever is in its slot, except that a
+  shallower result never overwrites a deeper one for the same position.
+- Evaluation: two-distance potential (Van Rijswijck). For each player and edge, a cell's distance is
+  1 + the second-best distance among its neighbours, since the opponent can always block the best one.
+  Own stone groups are transparent (distance 0 through them), opponent stones are walls.
+  The potential of a player is the minimum over empty cells of the sum of distances to both edges.
+*/
+#pragma once
+
+#include "Hex_Board.h"
+#include "Hex_FixedBoard.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Random keys used to hash a board position incrementally
+class ZobristKeys {
+private:
+    std::vector<uint64_t> keys; // two keys per cell: [2 * cell] BLUE, [2 * cell + 1] RED
+    uint64_t side_key;          // toggled whenever the side to move changes
+
+public:
+    ZobristKeys(int cells, uint64_t seed = 0x9E3779B97F4A7C15ULL) : keys(2 * cells) {
+        std::mt19937_64 gen(seed); // fixed seed so hashes are reproducible between runs
+        for (auto& k : keys)
+            k = gen();
+        side_key = gen();
+    }
+
+    uint64_t piece(int cell, Player p) const {
+        return keys[2 * cell + (p == Player::RED ? 1 : 0)];
+    }
+
+    uint64_t side() const { return side_key; }
+
+    // Full hash of a position (used at the root; the search updates it incrementally)
+    uint64_t hash(const std::vector<Player>& board, Player to_move) const {
+        uint64_t h = 0;
+        for (int i = 0; i < static_cast<int>(board.size()); ++i) {
+            if (board[i] != Player::NONE)
+                h ^= piece(i, board[i]);
+        }
+        if (to_move == Player::RED)
+            h ^= side_key;
+        return h;
+    }
+};
+
+enum class Bound : uint8_t { EXACT, LOWER, UPPER };
+
+struct TTEntry {
+    uint64_t key = 0;
+    int32_t score = 0;
+    int16_t best_move = -1;
+    int8_t depth = -1;          // -1 marks an empty slot; deeper searches are stored as depth 127
+    Bound bound = Bound::EXACT;
+};
+
+// Fixed-size hash table of previously searched positions
+class TranspositionTable {
+private:
+    std::vector<TTEntry> table;
+    uint64_t mask;
+
+public:
+    explicit TranspositionTable(size_t megabytes = 16) {
+        resize(megabytes);
+    }
+
+    // Number of entries is rounded down to a power of two so the index is a simple mask
+    void resize(size_t megabytes) {
+        size_t wanted = std::max<size_t>(1, megabytes * 1024 * 1024 / sizeof(TTEntry));
+        size_t entries = 1;
+        while (entries * 2 <= wanted)
+            entries *= 2;
+        table.assign(entries, TTEntry());
+        mask = entries - 1;
+    }
+
+    void clear() {
+        std::fill(table.begin(), table.end(), TTEntry());
+    }
+
+    bool probe(uint64_t key, TTEntry& out) const {
+        const TTEntry& e = table[key & mask];
+        if (e.depth < 0 || e.key != key)
+            return false;
+        out = e;
+        return true;
+    }
+
+    void store(uint64_t key, int depth, int score, Bound bound, int best_move) {
+        TTEntry& e = table[key & mask];
+        depth = std::min(depth, 127);   // claiming less depth than searched is safe, wrapping is not
+        if (e.depth >= 0 && e.key == key && e.depth > depth)
+            return; // keep the deeper result for the same position
+        e.key = key;
+        e.depth = static_cast<int8_t>(depth);
+        e.score = score;
+        e.bound = bound;
+        e.best_move = static_cast<int16_t>(best_move);
+    }
+
+    size_t capacity() const { return table.size(); }
+    size_t size_bytes() const { return table.size() * sizeof(TTEntry); }
+};
+
+struct SearchLimits {
+    int max_depth = 64;         // plies
+    double max_seconds = 1.0;   // wall clock budget, <= 0 means no time limit
+};
+
+struct SearchStats {
+    uint64_t nodes = 0;         // calls to negamax (root excluded)
+    uint64_t evaluations = 0;   // leaf evaluations
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;       // probes that found the same position
+    uint64_t tt_cutoffs = 0;    // hits whose bound ended the node immediately
+    uint64_t beta_cutoffs = 0;
+    int completed_depth = 0;
+    double seconds = 0.0;
+
+    double nodes_per_second() const {
+        return seconds > 0.0 ? nodes / seconds : 0.0;
+    }
+
+    double tt_hit_rate() const {
+        return tt_probes > 0 ? static_cast<double>(tt_hits) / tt_probes : 0.0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const SearchStats& s) {
+        out << "depth " << s.completed_depth
+            << " | nodes " << s.nodes
+            << " | evals " << s.evaluations
+            << " | time " << std::fixed << std::setprecision(3) << s.seconds << "s"
+            << " | nps " << std::setprecision(0) << s.nodes_per_second()
+            << " | TT hit rate " << std::setprecision(1) << 100.0 * s.tt_hit_rate() << "%"
+            << " (" << s.tt_cutoffs << " cutoffs)"
+            << " | beta cutoffs " << s.beta_cutoffs;
+        out.unsetf(std::ios::fixed);
+        return out;
+    }
+};
+
+struct SearchResult {
+    int best_move = -1;
+    int score = 0;              // from the point of view of the side to move
+    SearchStats stats;
+};
+
+// Two-distance potential evaluation; keeps its work buffers between calls to avoid allocations
+class TwoDistanceEvaluator {
+private:
+    enum { INF = 1 << 20 };                 // unreachable (enum so it can be passed by reference)
+
+    const Graph& g;
+    int size;
+    int cells;
+    std::vector<int> group;                 // group id of each stone of the evaluated player, -1 otherwise
+    std::vector<int> group_start, group_cells; // stones of each group, flattened
+    std::vector<int> dist_a, dist_b;        // distance of every node (cells, then groups) from each edge
+    std::vector<int> count;                 // finalised neighbours seen by each empty cell
+    std::vector<bool> done;
+    std::vector<int> stamp;                 // de-duplicates targets while expanding a group
+    int stamp_id = 0;
+    std::vector<std::vector<int>> buckets;  // bucket queue indexed by distance
+    std::vector<int> stk;
+
+    bool on_edge(int cell, Player p, bool first) const {
+        int r = cell / size, c = cell % size;
+        if (p == Player::BLUE)
+            return first ? r == 0 : r == size - 1;
+        return first ? c == 0 : c == size - 1;
+    }
+
+    void build_groups(const std::vector<Player>& board, Player p) {
+        group.assign(cells, -1);
+        group_start.clear();
+        group_cells.clear();
+        for (int s = 0; s < cells; ++s) {
+            if (board[s] != p || group[s] != -1)
+                continue;
+            int id = static_cast<int>(group_start.size());
+            group_start.push_back(static_cast<int>(group_cells.size()));
+            group[s] = id;
+            stk.assign(1, s);
+            while (!stk.empty()) {
+                int u = stk.back(); stk.pop_back();
+                group_cells.push_back(u);
+                for (int v : g.neighbors(u)) {
+                    if (board[v] == p && group[v] == -1) {
+                        group[v] = id;
+                        stk.push_back(v);
+                    }
+                }
+            }
+        }
+        group_start.push_back(static_cast<int>(group_cells.size()));
+    }
+
+    void push(int d, int node, std::vector<int>& dist) {
+        dist[node] = d;
+        if (d >= static_cast<int>(buckets.size()))
+            buckets.resize(d + 1);
+        buckets[d].push_back(node);
+    }
+
+    // Relax one neighbour 'v' of node 'u' (which was finalised at distance k)
+    void relax(const std::vector<Player>& board, Player p, int v, int k, bool from_edge_group, std::vector<int>& dist) {
+        if (board[v] == opponent(p))
+            return;
+        int t = board[v] == p ? cells + group[v] : v;
+        if (done[t] || stamp[t] == stamp_id)
+            return;
+        stamp[t] = stamp_id;
+        if (t >= cells) {                       // own group: transparent
+            if (k < dist[t])
+                push(k, t, dist);
+            return;
+        }
+        int cand;
+        if (from_edge_group)
+            cand = 1;                           // touching an edge-connected group is like touching the edge
+        else if (++count[t] < 2)
+            return;                             // the opponent would block the only way in
+        else
+            cand = k + 1;
+        if (cand < dist[t])
+            push(cand, t, dist);
+    }
+
+    void edge_distances(const std::vector<Player>& board, Player p, bool first, std::vector<int>& dist) {
+        int nodes = cells + static_cast<int>(group_start.size()) - 1;
+        dist.assign(nodes, INF);
+        count.assign(cells, 0);
+        done.assign(nodes, false);
+        stamp.assign(nodes, 0);
+        stamp_id = 0;
+        for (auto& b : buckets)
+            b.clear();
+
+        for (int c = 0; c < cells; ++c) {
+            if (!on_edge(c, p, first))
+                continue;
+            if (board[c] == p && dist[cells + group[c]] != 0)
+                push(0, cells + group[c], dist);
+            else if (board[c] == Player::NONE)
+                push(1, c, dist);
+        }
+
+        for (int k = 0; k < static_cast<int>(buckets.size()); ++k) {
+            for (size_t i = 0; i < buckets[k].size(); ++i) {
+                int u = buckets[k][i];
+                if (done[u] || dist[u] != k)
+                    continue;                   // stale entry
+                done[u] = true;
+                ++stamp_id;
+                if (u < cells) {
+                    for (int v : g.neighbors(u))
+                        relax(board, p, v, k, false, dist);
+                }
+                else {
+                    int id = u - cells;
+                    for (int j = group_start[id]; j < group_start[id + 1]; ++j)
+                        for (int v : g.neighbors(group_cells[j]))
+                            relax(board, p, v, k, k == 0, dist);
+                }
+            }
+        }
+    }
+
+public:
+    explicit TwoDistanceEvaluator(const Graph& graph)
+        : g(graph), size(graph.get_size()), cells(graph.get_size()* graph.get_size()) {
+    }
+
+    // Lower is better: number of empty cells still needed, assuming the opponent blocks
+    int potential(const std::vector<Player>& board, Player p) {
+        build_groups(board, p);
+        edge_distances(board, p, true, dist_a);
+        edge_distances(board, p, false, dist_b);
+        int best = INF;
+        for (int c = 0; c < cells; ++c) {
+            if (board[c] == Player::NONE && dist_a[c] < INF && dist_b[c] < INF)
+                best = std::min(best, dist_a[c] + dist_b[c]);
+        }
+        return std::min(best, 2 * cells);
+    }
+
+    // Score from the point of view of the side to move
+    int evaluate(const std::vector<Player>& board, Player to_move) {
+        return 100 * (potential(board, opponent(to_move)) - potential(board, to_move));
+    }
+};
+
+class AlphaBetaSearch {
+public:
+    static const int WIN = 1000000;         // scores above WIN - MAX_PLY are forced wins
+    static const int MAX_PLY = 256;
+
+    explicit AlphaBetaSearch(const Graph& graph, size_t tt_megabytes = 16)
+        : g(graph), size(graph.get_size()), cells(graph.get_size()* graph.get_size()),
+          zobrist(graph.get_size()* graph.get_size()), tt(tt_megabytes), evaluator(graph), checker(graph),
+          history(2 * cells, 0), killers(MAX_PLY, { -1, -1 }), moves(MAX_PLY), visited(cells, 0) {
+    }
+
+    void set_tt_size(size_t megabytes) { tt.resize(megabytes); }
+    const TranspositionTable& table() const { return tt; }
+
+    // Forget everything learnt in previous searches (TT, killers, history)
+    void clear() {
+        tt.clear();
+        std::fill(history.begin(), history.end(), 0);
+        for (auto& k : killers)
+            k[0] = k[1] = -1;
+    }
+
+    SearchResult search(const std::vector<Player>& position, Player to_move, const SearchLimits& limits = SearchLimits()) {
+        SearchResult result;
+        stats = SearchStats();
+        board = padded_board(position, size);
+        side = to_move;
+        aborted = false;
+        start = std::chrono::steady_clock::now();
+        deadline = limits.max_seconds;
+
+        uint64_t key = zobrist.hash(board, to_move);
+        int max_depth = std::min(limits.max_depth, MAX_PLY - 1);
+
+        for (int depth = 1; depth <= max_depth; ++depth) {
+            int best_move = -1;
+            int score = negamax(depth, -WIN - 1, WIN + 1, 0, to_move, key, -1, best_move);
+            if (aborted)
+                break;                          // keep the result of the last completed iteration
+            result.best_move = best_move;
+            result.score = score;
+            stats.completed_depth = depth;
+            if (std::abs(score) >= WIN - MAX_PLY)
+                break;                          // forced result found, deeper search cannot change it
+            if (depth >= empty_cells())
+                break;                          // whole game tree searched
+        }
+
+        if (result.best_move == -1)             // time ran out during depth 1
+            result.best_move = get_random_move(position);
+
+        stats.seconds = elapsed();
+        result.stats = stats;
+        return result;
+    }
+
+    const SearchStats& last_stats() const { return stats; }
+
+private:
+    const Graph& g;
+    int size;
+    int cells;
+    ZobristKeys zobrist;
+    TranspositionTable tt;
+    TwoDistanceEvaluator evaluator;
+    WinChecker checker;                     // compile-time tables for the common board sizes
+
+    std::vector<int> history;               // [2 * cell + colour] cut-off counters
+    std::vector<std::array<int, 2>> killers;
+    std::vector<std::vector<std::pair<int, int>>> moves; // per ply (ordering score, cell)
+    std::vector<int> visited;               // stamps for the win check
+    int visit_id = 0;
+    std::vector<int> stk;
+
+    std::vector<Player> board;              // padded with the sentinel cell expected by WinChecker
+    Player side = Player::BLUE;
+    SearchStats stats;
+    bool aborted = false;
+    std::chrono::steady_clock::time_point start;
+    double deadline = 0.0;
+
+    double elapsed() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int empty_cells() const {
+        return static_cast<int>(std::count(board.begin(), board.begin() + cells, Player::NONE));
+    }
+
+    int colour(Player p) const { return p == Player::RED ? 1 : 0; }
+
+    // Only the group containing the last stone can have completed a connection
+    bool last_move_wins(int move, Player p) {
+        if (checker.specialised())
+            return checker.move_wins(board, move, p);
+        ++visit_id;
+        bool first = false, second = false;
+        stk.assign(1, move);
+        visited[move] = visit_id;
+        while (!stk.empty()) {
+            int u = stk.back(); stk.pop_back();
+            int r = u / size, c = u % size;
+            int along = p == Player::BLUE ? r : c;
+            first = first || along == 0;
+            second = second || along == size - 1;
+            if (first && second)
+                return true;
+            for (int v : g.neighbors(u)) {
+                if (board[v] == p && visited[v] != visit_id) {
+                    visited[v] = visit_id;
+                    stk.push_back(v);
+                }
+            }
+        }
+        return false;
+    }
+
+    // Mate scores are stored relative to the node so they stay valid at other plies
+    static int score_to_tt(int score, int ply) {
+        if (score >= WIN - MAX_PLY) return score + ply;
+        if (score <= -WIN + MAX_PLY) return score - ply;
+        return score;
+    }
+
+    static int score_from_tt(int score, int ply) {
+        if (score >= WIN - MAX_PLY) return score - ply;
+        if (score <= -WIN + MAX_PLY) return score + ply;
+        return score;
+    }
+
+    void order_moves(int ply, Player to_move, int tt_move) {
+        auto& list = moves[ply];
+        list.clear();
+        int mid = size / 2;
+        for (int c = 0; c < cells; ++c) {
+            if (board[c] != Player::NONE)
+                continue;
+            int score;
+            if (c == tt_move)
+                score = 1 << 30;
+            else if (c == killers[ply][0])
+                score = 1 << 29;
+            else if (c == killers[ply][1])
+                score = (1 << 29) - 1;
+            else {
+                int r = c / size, col = c % size;
+                score = 16 * history[2 * c + colour(to_move)] - std::abs(r - mid) - std::abs(col - mid);
+            }
+            list.push_back({ score, c });
+        }
+        std::sort(list.begin(), list.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+            return a.first > b.first;
+        });
+    }
+
+    int negamax(int depth, int alpha, int beta, int ply, Player to_move, uint64_t key, int last_move, int& best_move) {
+        if (ply > 0)
+            ++stats.nodes;
+        if ((stats.nodes & 1023) == 0 && deadline > 0.0 && elapsed() > deadline) {
+            aborted = true;
+            return 0;
+        }
+
+        // The player who just moved is the only one who can have won
+        if (last_move >= 0 && last_move_wins(last_move, opponent(to_move)))
+            return -(WIN - ply);
+
+        if (depth == 0 || ply >= MAX_PLY - 1) {
+            ++stats.evaluations;
+            return evaluator.evaluate(board, to_move);
+        }
+
+        int alpha_orig = alpha;
+        int tt_move = -1;
+        TTEntry entry;
+        ++stats.tt_probes;
+        if (tt.probe(key, entry)) {
+            ++stats.tt_hits;
+            tt_move = entry.best_move;
+            if (entry.depth >= depth && ply > 0) {
+                int s = score_from_tt(entry.score, ply);
+                if (entry.bound == Bound::EXACT ||
+                    (entry.bound == Bound::LOWER && s >= beta) ||
+                    (entry.bound == Bound::UPPER && s <= alpha)) {
+                    ++stats.tt_cutoffs;
+                    return s;
+                }
+            }
+        }
+
+        order_moves(ply, to_move, tt_move);
+        int best = -WIN - 1;
+        best_move = -1;
+        Player next = opponent(to_move);
+
+        for (size_t i = 0; i < moves[ply].size(); ++i) {
+            int m = moves[ply][i].second;
+            board[m] = to_move;
+            int child_best = -1;
+            int score = -negamax(depth - 1, -beta, -alpha, ply + 1, next,
+                key ^ zobrist.piece(m, to_move) ^ zobrist.side(), m, child_best);
+            board[m] = Player::NONE;
+            if (aborted)
+                return 0;
+
+            if (score > best) {
+                best = score;
+                best_move = m;
+            }
+            if (score > alpha)
+                alpha = score;
+            if (alpha >= beta) {
+                ++stats.beta_cutoffs;
+                if (killers[ply][0] != m) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = m;
+                }
+                history[2 * m + colour(to_move)] += depth * depth;
+                break;
+            }
+        }
+
+        Bound bound = best <= alpha_orig ? Bound::UPPER : (best >= beta ? Bound::LOWER : Bound::EXACT);
+        tt.store(key, depth, score_to_tt(best, ply), bound, best_move);
+        return best;
+    }
+};
@@ -0,0 +1,135 @@
+// Hex_Board.h : Board model shared by the game loop and the search code.
+//
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <stack>
+#include <random>
+
+#include "../../Common/Fast_Random.h"
+
+enum class Player { NONE = '.', BLUE = 'B', RED = 'R' };
+
+// BLUE connects top and bottom (vertical), RED connects left and right
+inline Player opponent(Player p) {
+    return p == Player::BLUE ? Player::RED : Player::BLUE;
+}
+
+class Graph {
+private:
+    int size;
+    std::vector<std::vector<int>> adj;
+
+    bool is_valid(int r, int c) const {
+        return r >= 0 && r < size && c >= 0 && c < size;
+    }
+
+public:
+    Graph(int s) : size(s), adj(s* s) {
+        int dr[] = { -1, -1, 0, 0, 1, 1 }; // neighbour: change in row
+        int dc[] = { 0, 1, -1, 1, -1, 0 }; // neighbour: change in column
+
+        for (int r = 0; r < size; ++r) {   // iterate rows
+            for (int c = 0; c < size; ++c) {  // iterate columns
+                int u = r * size + c;           // identify node in flattened adjacency list
+                for (int d = 0; d < 6; ++d) {   // iterate for each potential direction
+                    int nr = r + dr[d];
+                    int nc = c + dc[d];
+                    if (is_valid(nr, nc)) {     // ensures neighbour is in the board
+                        int v = nr * size + nc;
+                        adj[u].push_back(v);
+                    }
+                }
+            }
+        }
+    }
+
+    int get_size() const { return size; }
+
+    const std::vector<int>& neighbors(int node) const {
+        return adj[node];
+    }
+};
+
+inline void draw_board(const std::vector<Player>& board, int size) {
+    for (int r = 0; r < size; ++r) {
+        std::cout << std::string(r, ' ');
+        for (int c = 0; c < size; ++c) {
+            std::cout << static_cast<char>(board[r * size + c]) << " ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+inline bool dfs_check_win(const Graph& g, const std::vector<Player>& board, Player player, int size, bool vertical) {
+    std::vector<bool> visited(size * size, false);
+    std::stack<int> stk;
+
+    if (vertical) {
+        for (int col = 0; col < size; ++col) {
+            int idx = 0 * size + col;
+            if (board[idx] == player) {
+                stk.push(idx);
+                visited[idx] = true;
+            }
+        }
+    }
+    else {
+        for (int row = 0; row < size; ++row) {
+            int idx = row * size + 0;
+            if (board[idx] == player) {
+                stk.push(idx);
+                visited[idx] = true;
+            }
+        }
+    }
+
+    while (!stk.empty()) {
+        int curr = stk.top(); stk.pop(); // current flattened cell being explored in the DFS, then removed from stk
+        int r = curr / size, c = curr % size;
+
+        if (vertical && r == size - 1)
+            return true; // blue wins
+        if (!vertical && c == size - 1)
+            return true; // red wins
+
+        for (int nei : g.neighbors(curr)) {
+            if (!visited[nei] && board[nei] == player) {
+                visited[nei] = true;
+                stk.push(nei); // add neighbour of the same colour to continue path towards other end of the table, new "curr"
+            }
+        }
+    }
+
+    return false; // if stk is empty and no win is recorded, then player didn't win
+}
+
+// Convenience wrapper: BLUE always plays vertically, RED horizontally
+inline bool has_won(const Graph& g, const std::vector<Player>& board, Player player) {
+    return dfs_check_win(g, board, player, g.get_size(), player == Player::BLUE);
+}
+
+inline bool is_valid_move(const std::vector<Player>& board, int pos) {
+    return board[pos] == Player::NONE; // valid if no player already selected that node previously
+}
+
+// Uniformly random empty cell, or -1 if the board is full. The engine is any Fast_Random.h engine
+// or std::mt19937; concurrent games must each pass their own.
+template <class Engine>
+inline int get_random_move(const std::vector<Player>& board, Engine& rng) {
+    std::vector<int> empty;
+    for (int i = 0; i < static_cast<int>(board.size()); ++i) {
+        if (board[i] == Player::NONE)
+            empty.push_back(i);  // add all the available nodes/moves
+    }
+    if (empty.empty()) return -1; // if board is full no move can be done
+    return empty[bounded_rand(rng, static_cast<uint32_t>(empty.size()))]; // unbiased, unlike rand() % size
+}
+
+// Same, drawing from the calling thread's engine (seeded with seed_thread_rngs)
+inline int get_random_move(const std::vector<Player>& board) {
+    return get_random_move(board, thread_rng());
+}
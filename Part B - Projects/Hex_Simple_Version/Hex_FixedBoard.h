@@ -0,0 +1,202 @@
+// Hex_FixedBoard.h : Compile-time neighbour tables for fixed Hex board sizes.
+//
+/*
+Graph(int s) builds its adjacency lists at run time, one small vector per cell, and the win check
+recomputes row and column with a division on every visited cell. When the board size is known at
+compile time everything can be precomputed instead:
+
+- nbr[cell][6]: the six neighbours of every cell, with SENTINEL (== N * N) in place of the
+  off-board ones. Boards carry one extra cell at index SENTINEL that is always Player::NONE,
+  so the inner loops never need a bounds check: the sentinel never matches a player's colour.
+- edge[cell]: bit mask of the board edges the cell touches (TOP, BOTTOM, LEFT, RIGHT).
+
+Tables are built by a constexpr constructor, so they live in read-only data and cost nothing at
+run time. WinChecker picks the specialised code for the common sizes (7, 9, 11, 13) and falls back
+to the Graph-based check for any other size. The Monte Carlo playouts of those sizes run on a
+FixedBoard<N>, a padded std::array that lives on the stack.
+*/
+#pragma once
+
+#include "Hex_Board.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+enum EdgeMask : uint8_t { EDGE_TOP = 1, EDGE_BOTTOM = 2, EDGE_LEFT = 4, EDGE_RIGHT = 8 };
+
+template <int N>
+struct HexTables {
+    static constexpr int CELLS = N * N;
+    static constexpr int SENTINEL = N * N;
+
+    int16_t nbr[CELLS][6];
+    uint8_t edge[CELLS];
+
+    constexpr HexTables() : nbr(), edge() {
+        const int dr[6] = { -1, -1, 0, 0, 1, 1 }; // same neighbour order as Graph
+        const int dc[6] = { 0, 1, -1, 1, -1, 0 };
+        for (int r = 0; r < N; ++r) {
+            for (int c = 0; c < N; ++c) {
+                int u = r * N + c;
+                for (int d = 0; d < 6; ++d) {
+                    int nr = r + dr[d], nc = c + dc[d];
+                    bool inside = nr >= 0 && nr < N && nc >= 0 && nc < N;
+                    nbr[u][d] = static_cast<int16_t>(inside ? nr * N + nc : SENTINEL);
+                }
+                edge[u] = static_cast<uint8_t>((r == 0 ? EDGE_TOP : 0) | (r == N - 1 ? EDGE_BOTTOM : 0) |
+                    (c == 0 ? EDGE_LEFT : 0) | (c == N - 1 ? EDGE_RIGHT : 0));
+            }
+        }
+    }
+};
+
+// One constant-initialised table per board size
+template <int N>
+inline const HexTables<N>& hex_tables() {
+    static constexpr HexTables<N> tables{};
+    return tables;
+}
+
+// Edges a player has to join: BLUE top-bottom, RED left-right
+inline uint8_t start_edge(Player p) { return p == Player::BLUE ? EDGE_TOP : EDGE_LEFT; }
+inline uint8_t goal_edge(Player p) { return p == Player::BLUE ? EDGE_BOTTOM : EDGE_RIGHT; }
+
+// Does 'p' connect its two edges? 'cells' must hold N * N + 1 entries, the last one Player::NONE.
+template <int N>
+bool fixed_has_won(const Player* cells, Player p) {
+    const HexTables<N>& t = hex_tables<N>();
+    bool visited[HexTables<N>::CELLS + 1] = {};
+    int16_t stk[HexTables<N>::CELLS];
+    int top = 0;
+    const uint8_t from = start_edge(p), to = goal_edge(p);
+
+    for (int u = 0; u < HexTables<N>::CELLS; ++u) {
+        if ((t.edge[u] & from) && cells[u] == p) {
+            visited[u] = true;
+            stk[top++] = static_cast<int16_t>(u);
+        }
+    }
+    while (top > 0) {
+        int u = stk[--top];
+        if (t.edge[u] & to)
+            return true;
+        for (int d = 0; d < 6; ++d) {
+            int v = t.nbr[u][d];
+            if (cells[v] == p && !visited[v]) {
+                visited[v] = true;
+                stk[top++] = static_cast<int16_t>(v);
+            }
+        }
+    }
+    return false;
+}
+
+// Did the stone just placed on 'move' complete a connection? Only its own group needs visiting.
+template <int N>
+bool fixed_move_wins(const Player* cells, int move, Player p) {
+    const HexTables<N>& t = hex_tables<N>();
+    bool visited[HexTables<N>::CELLS + 1] = {};
+    int16_t stk[HexTables<N>::CELLS];
+    int top = 0;
+    const uint8_t want = start_edge(p) | goal_edge(p);
+    uint8_t reached = 0;
+
+    visited[move] = true;
+    stk[top++] = static_cast<int16_t>(move);
+    while (top > 0) {
+        int u = stk[--top];
+        reached |= t.edge[u];
+        if ((reached & want) == want)
+            return true;
+        for (int d = 0; d < 6; ++d) {
+            int v = t.nbr[u][d];
+            if (cells[v] == p && !visited[v]) {
+                visited[v] = true;
+                stk[top++] = static_cast<int16_t>(v);
+            }
+        }
+    }
+    return false;
+}
+
+// Allocation-free board of a fixed size, padded with the sentinel cell
+template <int N>
+class FixedBoard {
+private:
+    std::array<Player, N * N + 1> cells;
+
+public:
+    static constexpr int SIZE = N;
+    static constexpr int CELLS = N * N;
+
+    FixedBoard() { cells.fill(Player::NONE); }
+
+    explicit FixedBoard(const std::vector<Player>& board) {
+        cells.fill(Player::NONE);
+        for (int i = 0; i < CELLS; ++i)
+            cells[i] = board[i];
+    }
+
+    Player get(int cell) const { return cells[cell]; }
+    void set(int cell, Player p) { cells[cell] = p; }
+    Player& operator[](int cell) { return cells[cell]; }
+    const Player* data() const { return cells.data(); }
+
+    bool has_won(Player p) const { return fixed_has_won<N>(cells.data(), p); }
+    bool move_wins(int move, Player p) const { return fixed_move_wins<N>(cells.data(), move, p); }
+
+    std::vector<Player> to_vector() const {
+        return std::vector<Player>(cells.begin(), cells.begin() + CELLS);
+    }
+};
+
+// Win checks for a board size chosen at run time: specialised for 7, 9, 11 and 13, Graph DFS otherwise.
+// Boards passed in must be padded to size * size + 1 cells (see padded_board).
+class WinChecker {
+private:
+    using HasWonFn = bool (*)(const Player*, Player);
+    using MoveWinsFn = bool (*)(const Player*, int, Player);
+
+    const Graph& g;
+    HasWonFn has_won_fn = nullptr;
+    MoveWinsFn move_wins_fn = nullptr;
+
+    template <int N>
+    void use() {
+        has_won_fn = &fixed_has_won<N>;
+        move_wins_fn = &fixed_move_wins<N>;
+    }
+
+public:
+    explicit WinChecker(const Graph& graph) : g(graph) {
+        switch (graph.get_size()) {
+        case 7: use<7>(); break;
+        case 9: use<9>(); break;
+        case 11: use<11>(); break;
+        case 13: use<13>(); break;
+        default: break;
+        }
+    }
+
+    bool specialised() const { return has_won_fn != nullptr; }
+
+    bool has_won(const std::vector<Player>& board, Player p) const {
+        if (has_won_fn)
+            return has_won_fn(board.data(), p);
+        return ::has_won(g, board, p);
+    }
+
+    bool move_wins(const std::vector<Player>& board, int move, Player p) const {
+        if (move_wins_fn)
+            return move_wins_fn(board.data(), move, p);
+        return ::has_won(g, board, p);
+    }
+};
+
+// Copy of 'board' with the trailing sentinel cell expected by WinChecker
+inline std::vector<Player> padded_board(const std::vector<Player>& board, int size) {
+    std::vector<Player> padded(board.begin(), board.begin() + size * size);
+    padded.push_back(Player::NONE);
+    return padded;
+}
@@ -0,0 +1,182 @@
+// Hex_Players.h : Move-selection strategies that can be plugged into a game.
+//
+#pragma once
+
+#include "Hex_Board.h"
+#include "Hex_AlphaBeta.h"
+#include "Hex_FixedBoard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Base class for anything that can choose a move on a Hex board
+class HexAgent {
+public:
+    virtual ~HexAgent() {}
+    virtual int choose_move(const std::vector<Player>& board, Player to_move) = 0;
+    virtual std::string name() const = 0;
+};
+
+// Uniformly random legal move
+class RandomAgent : public HexAgent {
+private:
+    xoshiro256ss rng;
+
+public:
+    explicit RandomAgent(uint32_t seed) : rng(seed) {}
+
+    int choose_move(const std::vector<Player>& board, Player) override {
+        return get_random_move(board, rng);
+    }
+
+    std::string name() const override { return "random"; }
+};
+
+// For every legal move, fill the rest of the board at random 'playouts' times and keep the move
+// that wins most often. A full Hex board always has exactly one winner, so one check per playout is enough.
+// On 7x7, 9x9, 11x11 and 13x13 the playouts run on a FixedBoard<N> on the stack, with the
+// compile-time tables; other sizes use a padded vector and the Graph check.
+class MonteCarloAgent : public HexAgent {
+private:
+    using WinsFn = int (MonteCarloAgent::*)(const std::vector<Player>&, int, Player);
+
+    WinChecker checker;
+    int playouts;
+    xoshiro256ss rng;
+    std::vector<int> empty;
+    std::vector<Player> trial;  // padded with the sentinel cell expected by WinChecker
+    WinsFn wins_fn;
+
+    // Fill the empty cells (all but m) in a random order, the opponent first
+    template <class Board>
+    void fill_at_random(Board& b, Player to_move) {
+        shuffle_range(empty.begin(), empty.end(), rng);
+        Player next = opponent(to_move);
+        for (int cell : empty) {
+            b[cell] = next;
+            next = opponent(next);
+        }
+    }
+
+    // Playouts won by to_move after playing m
+    template <int N>
+    int fixed_wins(const std::vector<Player>& board, int m, Player to_move) {
+        FixedBoard<N> start(board);
+        start.set(m, to_move);
+        int wins = 0;
+        for (int k = 0; k < playouts; ++k) {
+            FixedBoard<N> b = start;
+            fill_at_random(b, to_move);
+            if (b.has_won(to_move))
+                ++wins;
+        }
+        return wins;
+    }
+
+    int vector_wins(const std::vector<Player>& board, int m, Player to_move) {
+        int wins = 0;
+        for (int k = 0; k < playouts; ++k) {
+            std::copy(board.begin(), board.end(), trial.begin());
+            trial[m] = to_move;
+            fill_at_random(trial, to_move);
+            if (checker.has_won(trial, to_move))
+                ++wins;
+        }
+        return wins;
+    }
+
+public:
+    MonteCarloAgent(const Graph& graph, int n_playouts, uint32_t seed)
+        : checker(graph), playouts(n_playouts), rng(seed),
+          trial(graph.get_size()* graph.get_size() + 1, Player::NONE), wins_fn(&MonteCarloAgent::vector_wins) {
+        switch (graph.get_size()) {
+        case 7: wins_fn = &MonteCarloAgent::fixed_wins<7>; break;
+        case 9: wins_fn = &MonteCarloAgent::fixed_wins<9>; break;
+        case 11: wins_fn = &MonteCarloAgent::fixed_wins<11>; break;
+        case 13: wins_fn = &MonteCarloAgent::fixed_wins<13>; break;
+        default: break;
+        }
+    }
+
+    int choose_move(const std::vector<Player>& board, Player to_move) override {
+        int best_move = -1, best_wins = -1;
+        for (int m = 0; m < static_cast<int>(board.size()); ++m) {
+            if (board[m] != Player::NONE)
+                continue;
+            empty.clear();
+            for (int i = 0; i < static_cast<int>(board.size()); ++i) {
+                if (board[i] == Player::NONE && i != m)
+                    empty.push_back(i);
+            }
+            int wins = (this->*wins_fn)(board, m, to_move);
+            if (wins > best_wins) {
+                best_wins = wins;
+                best_move = m;
+            }
+        }
+        return best_move;
+    }
+
+    std::string name() const override { return "mc:" + std::to_string(playouts); }
+};
+
+// Alpha-Beta searcher with a fixed depth and/or time budget per move
+class AlphaBetaAgent : public HexAgent {
+private:
+    AlphaBetaSearch engine;
+    SearchLimits limits;
+
+public:
+    AlphaBetaAgent(const Graph& graph, int depth, double seconds, size_t tt_megabytes)
+        : engine(graph, tt_megabytes) {
+        limits.max_depth = depth;
+        limits.max_seconds = seconds;
+    }
+
+    int choose_move(const std::vector<Player>& board, Player to_move) override {
+        return engine.search(board, to_move, limits).best_move;
+    }
+
+    std::string name() const override { return "ab:" + std::to_string(limits.max_depth); }
+};
+
+// Text description of a player, e.g. "random", "mc:200" (playouts per move), "ab:4" (search depth)
+struct AgentSpec {
+    std::string kind = "random";
+    int param = 0;
+    double seconds = 0.0;   // time limit per move for "ab", 0 means depth only
+    size_t tt_megabytes = 4;
+
+    static AgentSpec parse(const std::string& text) {
+        AgentSpec spec;
+        size_t colon = text.find(':');
+        spec.kind = text.substr(0, colon);
+        if (colon != std::string::npos)
+            spec.param = std::atoi(text.c_str() + colon + 1);
+        if (spec.kind == "mc" && spec.param <= 0)
+            spec.param = 200;
+        if (spec.kind == "ab" && spec.param <= 0)
+            spec.param = 3;
+        if (spec.kind != "random" && spec.kind != "mc" && spec.kind != "ab")
+            throw std::invalid_argument("unknown player type: " + text);
+        return spec;
+    }
+
+    std::string to_string() const {
+        return kind == "random" ? kind : kind + ":" + std::to_string(param);
+    }
+
+    std::unique_ptr<HexAgent> create(const Graph& g, uint32_t seed) const {
+        if (kind == "mc")
+            return std::unique_ptr<HexAgent>(new MonteCarloAgent(g, param, seed));
+        if (kind == "ab")
+            return std::unique_ptr<HexAgent>(new AlphaBetaAgent(g, param, seconds, tt_megabytes));
+        return std::unique_ptr<HexAgent>(new RandomAgent(seed));
+    }
+};
@@ -0,0 +1,617 @@
+// Hex_ProofNumber.h : Exact win/loss solver for small Hex boards (depth-first proof-number search).
+//
+/*
+Alpha-beta answers "which move looks best"; this solver answers "who wins with perfect play", for
+any position on boards of up to 8x8 (one bit per cell in a 64-bit mask).
+
+- Depth-first proof-number search (df-pn, Nagai), in negamax form. Every position has a proof
+  number phi (how many leaves must still be proved to show the side to move wins) and a disproof
+  number delta (to show it loses); phi = min of the children's delta, delta = sum of their phi.
+  The search always goes into the most-proving child, with thresholds that keep it there until
+  another child becomes more promising (the 1 + epsilon rule of Pawlewicz and Lew is used for the
+  second-best threshold, which avoids thrashing between two children).
+- Transposition table: Zobrist keys as in Hex_AlphaBeta.h, buckets of two entries, the entry with
+  less search work below it is replaced first. Stones are never removed, so positions form a DAG
+  without cycles and stored (phi, delta) values do not depend on the path.
+- Virtual connections (Anshelevich): stones are linked by adjacency, by bridges (two stones with
+  two empty common neighbours: if one is taken, play the other) and by edge templates (a stone on
+  the second row with its two edge neighbours empty). A chain of such links between a player's two
+  edges whose empty "carrier" cells are all distinct wins even with the opponent to move.
+  - If the player who just moved has such a chain, the position is lost for the side to move.
+  - If the side to move makes one with a single stone, it is won, without searching further.
+  - Otherwise every opponent threat (a cell that would give the opponent such a chain, and its
+    carrier) must be answered inside that threat; only the cells common to all threats (the
+    must-play region) are searched, the other moves are known to lose. An empty region is a loss.
+  The chains found are a subset of all virtual connections, so pruning is always sound; stronger
+  templates would only prune more.
+- Parallel root split (solve_parallel): the moves of the root are handed out to threads one at a
+  time, each solving the resulting position with its own solver and table. The first winning move
+  stops the others, unless every move is wanted (opening books).
+
+Exhaustive search still grows quickly with the number of empty cells. On one core the empty 5x5
+board takes a fraction of a second and 6x6 about a minute and a half. On 7x7, positions with a
+dozen or more stones are usually solved within seconds to a minute, but the opening is out of
+reach without much stronger connection rules (H-search, larger edge templates).
+*/
+#pragma once
+
+#include "Hex_Board.h"
+#include "Hex_AlphaBeta.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace pn_detail {
+
+    inline int lowest_bit(uint64_t m) {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, m);
+        return static_cast<int>(i);
+#else
+        return __builtin_ctzll(m);
+#endif
+    }
+
+    inline int bit_count(uint64_t m) {
+        int n = 0;
+        for (; m; m &= m - 1)
+            ++n;
+        return n;
+    }
+
+    inline uint64_t bit(int cell) { return 1ULL << cell; }
+}
+
+// Connections of one player's stones between its two edges, on cell bit masks
+class VirtualConnections {
+public:
+    explicit VirtualConnections(const Graph& g) : cells(g.get_size() * g.get_size()), nbr(cells, 0), bridges(cells) {
+        const int size = g.get_size();
+        if (cells > 64)
+            throw std::invalid_argument("VirtualConnections: boards of up to 8x8 only");
+        for (int u = 0; u < cells; ++u)
+            for (int v : g.neighbors(u))
+                nbr[u] |= pn_detail::bit(v);
+
+        // Bridges: u and v not adjacent, with exactly two common neighbours
+        for (int u = 0; u < cells; ++u) {
+            for (int v = 0; v < cells; ++v) {
+                uint64_t common = nbr[u] & nbr[v];
+                if (v != u && !(nbr[u] & pn_detail::bit(v)) && pn_detail::bit_count(common) == 2)
+                    bridges[u].push_back({ v, common });
+            }
+        }
+
+        // Edges: 0 top, 1 bottom (BLUE), 2 left, 3 right (RED); template cells have two edge neighbours
+        for (int e = 0; e < 4; ++e) {
+            edge[e] = 0;
+            for (int c = 0; c < cells; ++c) {
+                int r = c / size, col = c % size;
+                if ((e == 0 && r == 0) || (e == 1 && r == size - 1) || (e == 2 && col == 0) || (e == 3 && col == size - 1))
+                    edge[e] |= pn_detail::bit(c);
+            }
+            edge_template[e].assign(cells, 0);
+            for (int c = 0; c < cells; ++c)
+                if (!(edge[e] & pn_detail::bit(c)) && pn_detail::bit_count(nbr[c] & edge[e]) == 2)
+                    edge_template[e][c] = nbr[c] & edge[e];
+        }
+    }
+
+    // Do p's stones (own) join its two edges?
+    bool connected(uint64_t own, Player p) const {
+        const uint64_t goal = edge[goal_edge(p)];
+        uint64_t reached = own & edge[start_edge(p)], frontier = reached;
+        while (frontier) {
+            int u = pn_detail::lowest_bit(frontier);
+            frontier &= frontier - 1;
+            uint64_t grow = nbr[u] & own & ~reached;
+            reached |= grow;
+            frontier |= grow;
+        }
+        return (reached & goal) != 0;
+    }
+
+    // A chain of adjacent stones, bridges and edge templates joining p's edges, whose empty cells
+    // (returned in carrier) are all distinct. Breadth-first over whole stone groups, so the chain
+    // found has few links; a chain whose links overlap is not used.
+    bool connection(uint64_t own, uint64_t empty, Player p, uint64_t& carrier) const {
+        const int start = start_edge(p), goal = goal_edge(p);
+        int parent[64], queue[64], head = 0, tail = 0;
+        uint64_t link[64];
+        uint64_t seen = 0;
+
+        auto enter = [&](int v, int from, uint64_t via) {
+            // v and the rest of its group (joined to v by adjacency, so with no carrier)
+            seen |= pn_detail::bit(v);
+            parent[v] = from;
+            link[v] = via;
+            queue[tail++] = v;
+            for (int i = tail - 1; i < tail; ++i) {
+                uint64_t grow = nbr[queue[i]] & own & ~seen;
+                while (grow) {
+                    int w = pn_detail::lowest_bit(grow);
+                    grow &= grow - 1;
+                    seen |= pn_detail::bit(w);
+                    parent[w] = queue[i];
+                    link[w] = 0;
+                    queue[tail++] = w;
+                }
+            }
+        };
+
+        for (uint64_t s = own; s; s &= s - 1) {
+            int u = pn_detail::lowest_bit(s);
+            if (seen & pn_detail::bit(u))
+                continue;
+            if (edge[start] & pn_detail::bit(u))
+                enter(u, -1, 0);
+            else if (edge_template[start][u] && (edge_template[start][u] & empty) == edge_template[start][u])
+                enter(u, -1, edge_template[start][u]);
+        }
+
+        while (head < tail) {
+            int u = queue[head++];
+            uint64_t last;
+            if (edge[goal] & pn_detail::bit(u))
+                last = 0;
+            else if (edge_template[goal][u] && (edge_template[goal][u] & empty) == edge_template[goal][u])
+                last = edge_template[goal][u];
+            else
+                last = ~0ULL;
+            if (last != ~0ULL) {
+                uint64_t total = last;
+                bool disjoint = true;
+                for (int x = u; x != -1 && disjoint; x = parent[x]) {
+                    disjoint = (total & link[x]) == 0;
+                    total |= link[x];
+                }
+                if (disjoint) {
+                    carrier = total;
+                    return true;
+                }
+            }
+            for (const Bridge& b : bridges[u])
+                if ((own & pn_detail::bit(b.cell)) && !(seen & pn_detail::bit(b.cell)) && (b.carrier & empty) == b.carrier)
+                    enter(b.cell, u, b.carrier);
+        }
+        return false;
+    }
+
+private:
+    struct Bridge {
+        int cell;
+        uint64_t carrier;       // the two common neighbours
+    };
+
+    int cells;
+    std::vector<uint64_t> nbr;                  // neighbours of each cell
+    std::vector<std::vector<Bridge>> bridges;
+    uint64_t edge[4];                           // cells on each edge
+    std::vector<uint64_t> edge_template[4];     // the two edge cells of each second-row cell, or 0
+
+    static int start_edge(Player p) { return p == Player::BLUE ? 0 : 2; }
+    static int goal_edge(Player p) { return p == Player::BLUE ? 1 : 3; }
+};
+
+struct PNEntry {
+    uint64_t key = 0;
+    uint32_t phi = 0;           // phi = delta = 0 marks an empty slot
+    uint32_t delta = 0;
+    uint32_t work = 0;          // nodes searched below this position
+    int16_t best_move = -1;
+};
+
+// Hash table of (phi, delta), two entries per bucket
+class ProofTable {
+private:
+    std::vector<PNEntry> table;
+    uint64_t mask;
+
+public:
+    explicit ProofTable(size_t megabytes = 64) { resize(megabytes); }
+
+    void resize(size_t megabytes) {
+        size_t wanted = std::max<size_t>(2, megabytes * 1024 * 1024 / sizeof(PNEntry));
+        size_t entries = 2;
+        while (entries * 2 <= wanted)
+            entries *= 2;
+        table.assign(entries, PNEntry());
+        mask = (entries - 1) & ~1ULL;
+    }
+
+    void clear() { std::fill(table.begin(), table.end(), PNEntry()); }
+
+    const PNEntry* probe(uint64_t key) const {
+        const PNEntry* b = &table[key & mask];
+        if (b[0].key == key && (b[0].phi | b[0].delta))
+            return &b[0];
+        if (b[1].key == key && (b[1].phi | b[1].delta))
+            return &b[1];
+        return nullptr;
+    }
+
+    void store(uint64_t key, uint32_t phi, uint32_t delta, uint64_t work, int best_move) {
+        PNEntry* b = &table[key & mask];
+        PNEntry* e = b[0].key == key ? &b[0] : b[1].key == key ? &b[1] : b[0].work <= b[1].work ? &b[0] : &b[1];
+        e->key = key;
+        e->phi = phi;
+        e->delta = delta;
+        e->work = static_cast<uint32_t>(std::min<uint64_t>(work, 0xFFFFFFFFu));
+        e->best_move = static_cast<int16_t>(best_move);
+    }
+
+    size_t capacity() const { return table.size(); }
+    size_t size_bytes() const { return table.size() * sizeof(PNEntry); }
+};
+
+struct ProofStats {
+    uint64_t nodes = 0;         // positions expanded (calls of the df-pn step)
+    uint64_t proved = 0;        // positions shown won for the side to move
+    uint64_t disproved = 0;     // positions shown lost for the side to move
+    uint64_t vc_wins = 0;       // of these, proved by a virtual connection made in one move
+    uint64_t vc_losses = 0;     // disproved by an opponent connection or an empty must-play region
+    uint64_t pruned_moves = 0;  // moves outside the must-play region, never searched
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;
+    size_t memory_bytes = 0;    // transposition tables
+    int threads = 1;
+    double seconds = 0.0;
+
+    uint64_t solved() const { return proved + disproved; }
+    double solved_per_second() const { return seconds > 0.0 ? solved() / seconds : 0.0; }
+    double nodes_per_second() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+
+    // Sum of the counters of another thread's solver (time is wall clock, set by the caller)
+    void merge(const ProofStats& s) {
+        nodes += s.nodes;
+        proved += s.proved;
+        disproved += s.disproved;
+        vc_wins += s.vc_wins;
+        vc_losses += s.vc_losses;
+        pruned_moves += s.pruned_moves;
+        tt_probes += s.tt_probes;
+        tt_hits += s.tt_hits;
+        memory_bytes += s.memory_bytes;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const ProofStats& s) {
+        out << "nodes " << s.nodes
+            << " | solved " << s.solved() << " (" << s.proved << " won, " << s.disproved << " lost)"
+            << " | by connections " << s.vc_wins << " won, " << s.vc_losses << " lost"
+            << " | pruned moves " << s.pruned_moves
+            << " | time " << std::fixed << std::setprecision(3) << s.seconds << "s"
+            << " | solved/s " << std::setprecision(0) << s.solved_per_second()
+            << " | nodes/s " << s.nodes_per_second()
+            << " | TT " << std::setprecision(1) << s.memory_bytes / (1024.0 * 1024.0) << " MB on " << s.threads << " threads";
+        out.unsetf(std::ios::fixed);
+        return out;
+    }
+};
+
+struct ProofResult {
+    Player winner = Player::NONE;       // NONE if the time ran out first
+    int best_move = -1;                 // a winning move, when the side to move wins
+    std::vector<int> move_values;       // per cell: 1 wins, -1 loses, 0 occupied or not solved
+    ProofStats stats;
+};
+
+class ProofNumberSolver {
+public:
+    enum : uint32_t { INF = 1u << 30 };     // proof numbers of solved positions
+
+    explicit ProofNumberSolver(const Graph& graph, size_t tt_megabytes = 64)
+        : size(graph.get_size()), cells(graph.get_size() * graph.get_size()),
+          vc(graph), zobrist(graph.get_size() * graph.get_size()), tt(tt_megabytes) {
+        // Cells from the centre outwards: the order children are tried in when they tie
+        for (int c = 0; c < cells; ++c)
+            order.push_back(c);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return centre_distance(a) < centre_distance(b); });
+    }
+
+    void set_tt_size(size_t megabytes) { tt.resize(megabytes); }
+    const ProofTable& table() const { return tt; }
+    void clear() { tt.clear(); }
+
+    // Solves the position for to_move. Gives up (winner NONE) after max_seconds (<= 0: no limit)
+    // or when *stop becomes true.
+    ProofResult solve(const std::vector<Player>& position, Player to_move, double max_seconds = 0.0,
+        const std::atomic<bool>* stop = nullptr) {
+        ProofResult result;
+        start_search(position, max_seconds, stop);
+        uint32_t phi, delta;
+        uint64_t key = zobrist.hash(position, to_move);
+        mid(to_move, key, INF, INF, phi, delta);
+        if (!aborted && (phi == 0 || delta == 0)) {
+            result.winner = phi == 0 ? to_move : opponent(to_move);
+            if (const PNEntry* e = tt.probe(key))
+                result.best_move = phi == 0 ? e->best_move : -1;
+        }
+        finish_search(result.stats);
+        return result;
+    }
+
+    // The root's moves worth searching, in search order. Returns the winner if the position is
+    // decided without search (winning_move then holds a winning move, if the side to move wins).
+    Player root_moves(const std::vector<Player>& position, Player to_move, std::vector<int>& moves, int& winning_move) {
+        start_search(position, 0.0, nullptr);
+        int kids[64];
+        int count = 0;
+        winning_move = -1;
+        Player winner = Player::NONE;
+        switch (expand(to_move, kids, count, winning_move)) {
+        case WIN: winner = to_move; ++stats.proved; break;
+        case LOSS: winner = opponent(to_move); ++stats.disproved; break;
+        default: break;
+        }
+        moves.assign(kids, kids + count);
+        finish_search(stats);
+        return winner;
+    }
+
+    const ProofStats& last_stats() const { return stats; }
+
+private:
+    enum Outcome { OPEN, WIN, LOSS };
+
+    int size;
+    int cells;
+    VirtualConnections vc;
+    ZobristKeys zobrist;
+    ProofTable tt;
+    std::vector<int> order;
+
+    uint64_t stones[2] = { 0, 0 };      // BLUE, RED
+    ProofStats stats;
+    bool aborted = false;
+    const std::atomic<bool>* stop_flag = nullptr;
+    std::chrono::steady_clock::time_point start;
+    double deadline = 0.0;
+
+    int centre_distance(int c) const {
+        int r = c / size - size / 2, col = c % size - size / 2;
+        return std::abs(r) + std::abs(col) + std::abs(r + col);    // hex distance to the centre, doubled
+    }
+
+    static int colour(Player p) { return p == Player::RED ? 1 : 0; }
+
+    double elapsed() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); }
+
+    void start_search(const std::vector<Player>& position, double max_seconds, const std::atomic<bool>* stop) {
+        stats = ProofStats();
+        stones[0] = stones[1] = 0;
+        for (int c = 0; c < cells; ++c)
+            if (position[c] != Player::NONE)
+                stones[colour(position[c])] |= pn_detail::bit(c);
+        aborted = false;
+        stop_flag = stop;
+        start = std::chrono::steady_clock::now();
+        deadline = max_seconds;
+    }
+
+    void finish_search(ProofStats& out) {
+        stats.seconds = elapsed();
+        stats.memory_bytes = tt.size_bytes();
+        out = stats;
+    }
+
+    uint64_t empty_cells() const { return ~(stones[0] | stones[1]) & (cells == 64 ? ~0ULL : pn_detail::bit(cells) - 1); }
+
+    // Decides the position from connections, or lists the moves to search (the must-play region)
+    Outcome expand(Player to_move, int* kids, int& count, int& winning_move) {
+        const int me = colour(to_move), them = 1 - me;
+        const Player opp = opponent(to_move);
+        const uint64_t empty = empty_cells();
+        count = 0;
+        uint64_t carrier;
+        if (vc.connected(stones[them], opp) || vc.connected(stones[me], to_move))
+            return vc.connected(stones[me], to_move) ? WIN : LOSS;   // finished game
+        if (vc.connection(stones[them], empty, opp, carrier)) {
+            ++stats.vc_losses;
+            return LOSS;
+        }
+
+        uint64_t must = empty;
+        for (uint64_t e = empty; e; e &= e - 1) {
+            int c = pn_detail::lowest_bit(e);
+            const uint64_t b = pn_detail::bit(c);
+            if (vc.connection(stones[me] | b, empty & ~b, to_move, carrier)) {
+                ++stats.vc_wins;
+                winning_move = c;
+                return WIN;
+            }
+            if (vc.connection(stones[them] | b, empty & ~b, opp, carrier))
+                must &= b | carrier;
+        }
+        if (!must) {
+            ++stats.vc_losses;
+            return LOSS;
+        }
+        stats.pruned_moves += pn_detail::bit_count(empty & ~must);
+        for (int c : order)
+            if (must & pn_detail::bit(c))
+                kids[count++] = c;
+        return OPEN;
+    }
+
+    void lookup(uint64_t key, uint32_t& phi, uint32_t& delta) {
+        ++stats.tt_probes;
+        if (const PNEntry* e = tt.probe(key)) {
+            ++stats.tt_hits;
+            phi = e->phi;
+            delta = e->delta;
+        }
+        else
+            phi = delta = 1;
+    }
+
+    // One df-pn step: searches below the position until phi >= th_phi or delta >= th_delta
+    void mid(Player to_move, uint64_t key, uint32_t th_phi, uint32_t th_delta, uint32_t& phi, uint32_t& delta) {
+        ++stats.nodes;
+        if ((stats.nodes & 1023) == 0 && ((stop_flag && stop_flag->load(std::memory_order_relaxed)) ||
+            (deadline > 0.0 && elapsed() > deadline)))
+            aborted = true;
+
+        lookup(key, phi, delta);
+        if (phi >= th_phi || delta >= th_delta || aborted)
+            return;
+
+        const uint64_t nodes_before = stats.nodes;
+        int kids[64];
+        int count = 0, best_move = -1;
+        Outcome outcome = expand(to_move, kids, count, best_move);
+        if (outcome != OPEN) {
+            phi = outcome == WIN ? 0u : uint32_t(INF);
+            delta = outcome == WIN ? uint32_t(INF) : 0u;
+            ++(outcome == WIN ? stats.proved : stats.disproved);
+            tt.store(key, phi, delta, 1, best_move);
+            return;
+        }
+
+        const int me = colour(to_move);
+        const uint64_t side_key = zobrist.side();
+        while (true) {
+            // phi is the smallest child delta, delta the sum of the child phis
+            uint32_t best_delta = INF, second_delta = INF, best_phi = 0;
+            uint64_t sum_phi = 0;
+            int best = -1;
+            for (int i = 0; i < count; ++i) {
+                uint32_t cp, cd;
+                lookup(key ^ zobrist.piece(kids[i], to_move) ^ side_key, cp, cd);
+                sum_phi += cp;
+                if (cd < best_delta) {
+                    second_delta = best_delta;
+                    best_delta = cd;
+                    best_phi = cp;
+                    best = kids[i];
+                }
+                else if (cd < second_delta)
+                    second_delta = cd;
+            }
+            phi = best_delta;
+            delta = static_cast<uint32_t>(std::min<uint64_t>(sum_phi, INF));
+            best_move = best;
+            if (phi >= th_phi || delta >= th_delta || aborted)
+                break;
+
+            // Stay in the best child until it stops being best, or this node reaches a threshold
+            uint32_t child_th_phi = static_cast<uint32_t>(std::min<uint64_t>(INF, uint64_t(th_delta) + best_phi - delta));
+            uint32_t child_th_delta = std::min<uint32_t>(th_phi, second_delta >= INF ? INF : std::max(second_delta + 1, second_delta + second_delta / 4));
+            uint32_t cp, cd;
+            stones[me] |= pn_detail::bit(best);
+            mid(opponent(to_move), key ^ zobrist.piece(best, to_move) ^ side_key, child_th_phi, child_th_delta, cp, cd);
+            stones[me] &= ~pn_detail::bit(best);
+        }
+
+        if (phi == 0)
+            ++stats.proved;
+        else if (delta == 0)
+            ++stats.disproved;
+        tt.store(key, phi, delta, stats.nodes - nodes_before + 1, best_move);
+    }
+};
+
+// Solves the position with the root moves shared out between threads (0: one per hardware
+// thread), each with its own table of tt_megabytes / threads. Stops at the first winning move,
+// unless all_moves asks for the value of every move.
+inline ProofResult solve_parallel(const Graph& g, const std::vector<Player>& position, Player to_move, int threads = 0,
+    size_t tt_megabytes = 64, double max_seconds = 0.0, bool all_moves = false)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    const int cells = g.get_size() * g.get_size();
+    if (threads <= 0)
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    ProofResult result;
+    result.move_values.assign(cells, 0);
+    std::vector<int> moves;
+    int winning_move = -1;
+    {
+        ProofNumberSolver root(g, 1);
+        Player decided = root.root_moves(position, to_move, moves, winning_move);
+        result.stats.merge(root.last_stats());
+        if (decided != Player::NONE && !(all_moves && decided == to_move)) {
+            result.winner = decided;
+            result.best_move = winning_move;
+            for (int c = 0; c < cells; ++c)
+                if (position[c] == Player::NONE && decided == opponent(to_move))
+                    result.move_values[c] = -1;
+            if (winning_move >= 0)
+                result.move_values[winning_move] = 1;
+            result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            return result;
+        }
+        if (decided == to_move) {
+            // every move is wanted: search them all
+            moves.clear();
+            for (int c = 0; c < cells; ++c)
+                if (position[c] == Player::NONE)
+                    moves.push_back(c);
+        }
+        else {
+            // outside the must-play region every move loses
+            for (int c = 0; c < cells; ++c)
+                if (position[c] == Player::NONE && std::find(moves.begin(), moves.end(), c) == moves.end())
+                    result.move_values[c] = -1;
+        }
+    }
+    threads = std::max(1, std::min<int>(threads, static_cast<int>(moves.size())));
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> stop(false);
+    std::vector<ProofStats> partial(threads);
+    auto worker = [&](int t) {
+        ProofNumberSolver solver(g, std::max<size_t>(1, tt_megabytes / threads));
+        std::vector<Player> child = position;
+        for (size_t i = next++; i < moves.size() && !stop; i = next++) {
+            double left = 0.0;
+            if (max_seconds > 0.0) {
+                left = max_seconds - std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                if (left <= 0.0)
+                    break;
+            }
+            const int m = moves[i];
+            child[m] = to_move;
+            ProofResult r = solver.solve(child, opponent(to_move), left, &stop);
+            child[m] = Player::NONE;
+            r.stats.memory_bytes = 0;   // the same table every time: counted once below
+            partial[t].merge(r.stats);
+            if (r.winner != Player::NONE)
+                result.move_values[m] = r.winner == to_move ? 1 : -1;   // one slot per move, no lock needed
+            if (r.winner == to_move && !all_moves)
+                stop = true;
+        }
+        partial[t].memory_bytes = solver.table().size_bytes();
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool)
+        th.join();
+
+    for (const ProofStats& s : partial)
+        result.stats.merge(s);
+    bool all_lost = true;
+    for (int m : moves) {
+        if (result.move_values[m] == 1 && result.best_move == -1)
+            result.best_move = m;
+        all_lost = all_lost && result.move_values[m] == -1;
+    }
+    if (result.best_move >= 0)
+        result.winner = to_move;
+    else if (all_lost)
+        result.winner = opponent(to_move);
+    result.stats.threads = threads;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
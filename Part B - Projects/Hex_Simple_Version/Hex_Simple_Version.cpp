@@ -6,115 +6,191 @@
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
-#include <stack>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "Hex_Board.h"
+#include "Hex_AlphaBeta.h"
+#include "Hex_Tournament.h"
+#include "Hex_ProofNumber.h"
 
 using namespace std;
 
-enum class Player { NONE = '.', BLUE = 'B', RED = 'R' };
+// Search a single position from the empty board and report the engine statistics.
+// Usage: Hex_Simple_Version search [size] [depth] [seconds] [tt_megabytes]
+int run_search(int argc, char* argv[]) {
+    int size = argc > 2 ? atoi(argv[2]) : 5;
+    SearchLimits limits;
+    limits.max_depth = argc > 3 ? atoi(argv[3]) : 6;
+    limits.max_seconds = argc > 4 ? atof(argv[4]) : 10.0;
+    size_t tt_mb = argc > 5 ? static_cast<size_t>(atoi(argv[5])) : 16;
 
-class Graph {
-private:
-    int size;
-    vector<vector<int>> adj;
+    Graph g(size);
+    vector<Player> board(size * size, Player::NONE);
+    AlphaBetaSearch engine(g, tt_mb);
 
-    bool is_valid(int r, int c) const {
-        return r >= 0 && r < size && c >= 0 && c < size;
-    }
+    cout << "Alpha-Beta on " << size << "x" << size << " board, TT "
+        << engine.table().capacity() << " entries (" << engine.table().size_bytes() / (1024 * 1024) << " MB)\n";
 
-public:
-    Graph(int s) : size(s), adj(s* s) {
-        int dr[] = { -1, -1, 0, 0, 1, 1 }; // neighbour: change in row
-        int dc[] = { 0, 1, -1, 1, -1, 0 }; // neighbour: change in column
-
-        for (int r = 0; r < size; ++r) {   // iterate rows
-            for (int c = 0; c < size; ++c) {  // iterate columns
-                int u = r * size + c;           // identify node in flattened adjacency list
-                for (int d = 0; d < 6; ++d) {   // iterate for each potential direction
-                    int nr = r + dr[d];
-                    int nc = c + dc[d];
-                    if (is_valid(nr, nc)) {     // ensures neighbour is in the board
-                        int v = nr * size + nc;
-                        adj[u].push_back(v);
-                    }
+    SearchResult res = engine.search(board, Player::BLUE, limits);
+    cout << "Best move for BLUE: row " << res.best_move / size << ", col " << res.best_move % size
+        << " (score " << res.score << ")\n";
+    cout << res.stats << endl;
+    return 0;
+}
+
+// Play many games between two agents and write per-game results and win rates.
+// Usage: Hex_Simple_Version selfplay [games=N] [threads=N] [sizes=5,7,...] [first=random|mc:P|ab:D]
+//                                    [second=...] [ab_seconds=S] [seed=N] [out=prefix]
+// Writes <prefix>.csv (one row per game) and <prefix>.json (games plus summary).
+int run_selfplay(int argc, char* argv[]) {
+    TournamentConfig cfg;
+    cfg.threads = max(1u, thread::hardware_concurrency());
+    cfg.first = AgentSpec::parse("mc:100");
+    cfg.second = AgentSpec::parse("random");
+    string out = "selfplay";
+    double ab_seconds = 0.0;
+
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string value = eq == string::npos ? "" : arg.substr(eq + 1);
+        try {
+            if (key == "games") cfg.games = atoi(value.c_str());
+            else if (key == "threads") cfg.threads = atoi(value.c_str());
+            else if (key == "first") cfg.first = AgentSpec::parse(value);
+            else if (key == "second") cfg.second = AgentSpec::parse(value);
+            else if (key == "ab_seconds") ab_seconds = atof(value.c_str());
+            else if (key == "seed") cfg.seed = stoull(value);
+            else if (key == "out") out = value;
+            else if (key == "sizes") {
+                cfg.sizes.clear();
+                stringstream ss(value);
+                string item;
+                while (getline(ss, item, ','))
+                    cfg.sizes.push_back(atoi(item.c_str()));
+                if (cfg.sizes.empty() || *min_element(cfg.sizes.begin(), cfg.sizes.end()) < 1) {
+                    cerr << "sizes= needs one or more board sizes of at least 1" << endl;
+                    return 1;
                 }
             }
+            else {
+                cerr << "Unknown option: " << arg << endl;
+                return 1;
+            }
+        }
+        catch (const exception& e) {    // AgentSpec::parse and stoull reject malformed values
+            cerr << "Bad option " << arg << ": " << e.what() << endl;
+            return 1;
         }
     }
-
-    const vector<int>& neighbors(int node) const {
-        return adj[node];
+    if (cfg.games < 0 || cfg.threads < 1) {
+        cerr << "games= must be at least 0 and threads= at least 1" << endl;
+        return 1;
     }
-};
+    cfg.first.seconds = cfg.second.seconds = ab_seconds;
 
-void draw_board(const vector<Player>& board, int size) {
-    for (int r = 0; r < size; ++r) {
-        cout << string(r, ' ');
-        for (int c = 0; c < size; ++c) {
-            cout << static_cast<char>(board[r * size + c]) << " ";
-        }
-        cout << endl;
-    }
-}
+    cout << "Self-play: " << cfg.games << " games of " << cfg.first.to_string() << " vs "
+        << cfg.second.to_string() << " on " << cfg.threads << " threads\n";
+    auto t0 = chrono::steady_clock::now();
+    vector<GameRecord> results = run_tournament(cfg);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
 
-bool dfs_check_win(const Graph& g, const vector<Player>& board, Player player, int size, bool vertical) {
-    vector<bool> visited(size * size, false);
-    stack<int> stk;
+    ofstream csv(out + ".csv");
+    write_csv(csv, results);
+    ofstream json(out + ".json");
+    write_json(json, results);
 
-    if (vertical) {
-        for (int col = 0; col < size; ++col) {
-            int idx = 0 * size + col;
-            if (board[idx] == player) {
-                stk.push(idx);
-                visited[idx] = true;
-            }
-        }
-    }
-    else {
-        for (int row = 0; row < size; ++row) {
-            int idx = row * size + 0;
-            if (board[idx] == player) {
-                stk.push(idx);
-                visited[idx] = true;
-            }
-        }
-    }
-
-    while (!stk.empty()) {
-        int curr = stk.top(); stk.pop(); // current flattened cell being explored in the DFS, then removed from stk
-        int r = curr / size, c = curr % size;
+    print_summary(cout, results);
+    cout << "Finished in " << seconds << "s, results written to " << out << ".csv and " << out << ".json\n";
+    return 0;
+}
 
-        if (vertical && r == size - 1)
-            return true; // blue wins
-        if (!vertical && c == size - 1)
-            return true; // red wins
+// Exact result of a position: who wins with perfect play, and a winning move.
+// Usage: Hex_Simple_Version solve [size] [position] [threads] [tt_megabytes] [seconds]
+// The position lists the cells row by row as '.', 'B' or 'R' ("-" for the empty board);
+// BLUE moves first, so BLUE is to move when both have as many stones.
+int run_solve(int argc, char* argv[]) {
+    int size = argc > 2 ? atoi(argv[2]) : 4;
+    string position = argc > 3 ? argv[3] : "-";
+    int threads = argc > 4 ? atoi(argv[4]) : 0;
+    size_t tt_mb = argc > 5 ? static_cast<size_t>(atoi(argv[5])) : 64;
+    double seconds = argc > 6 ? atof(argv[6]) : 0.0;
+    if (size < 1 || size > 8) {
+        cerr << "The solver handles boards of 1x1 to 8x8." << endl;
+        return 1;
+    }
 
-        for (int nei : g.neighbors(curr)) {
-            if (!visited[nei] && board[nei] == player) {
-                visited[nei] = true;
-                stk.push(nei); // add neighbour of the same colour to continue path towards other end of the table, new "curr"
-            }
+    vector<Player> board(size * size, Player::NONE);
+    if (position != "-") {
+        if (static_cast<int>(position.size()) != size * size) {
+            cerr << "The position needs " << size * size << " cells." << endl;
+            return 1;
         }
+        for (int i = 0; i < size * size; ++i)
+            board[i] = position[i] == 'B' ? Player::BLUE : position[i] == 'R' ? Player::RED : Player::NONE;
     }
+    int blue = static_cast<int>(count(board.begin(), board.end(), Player::BLUE));
+    int red = static_cast<int>(count(board.begin(), board.end(), Player::RED));
+    Player to_move = blue > red ? Player::RED : Player::BLUE;
 
-    return false; // if stk is empty and no win is recorded, then player didn't win
+    Graph g(size);
+    draw_board(board, size);
+    ProofResult res = solve_parallel(g, board, to_move, threads, tt_mb, seconds);
+    string mover = to_move == Player::BLUE ? "BLUE" : "RED";
+    if (res.winner == Player::NONE)
+        cout << "Unsolved within " << seconds << "s\n";
+    else if (res.best_move < 0)
+        cout << (res.winner == Player::BLUE ? "BLUE" : "RED") << " has already won\n";
+    else if (res.winner == to_move)
+        cout << mover << " (to move) wins, e.g. with row " << res.best_move / size << ", col " << res.best_move % size << "\n";
+    else
+        cout << mover << " (to move) loses\n";
+    cout << res.stats << endl;
+    return 0;
 }
 
-bool is_valid_move(const vector<Player>& board, int pos) {
-    return board[pos] == Player::NONE; // valid if no player already selected that node previously
-}
+// Value of every first move on the empty board, for opening books: W wins for BLUE, L loses.
+// Usage: Hex_Simple_Version book [size] [threads] [tt_megabytes] [seconds]
+int run_book(int argc, char* argv[]) {
+    int size = argc > 2 ? atoi(argv[2]) : 4;
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    size_t tt_mb = argc > 4 ? static_cast<size_t>(atoi(argv[4])) : 64;
+    double seconds = argc > 5 ? atof(argv[5]) : 0.0;
+    if (size < 1 || size > 8) {
+        cerr << "The solver handles boards of 1x1 to 8x8." << endl;
+        return 1;
+    }
 
-int get_random_move(const vector<Player>& board) {
-    vector<int> empty;
-    for (int i = 0; i < board.size(); ++i) {
-        if (board[i] == Player::NONE)
-            empty.push_back(i);  // add all the available nodes/moves
+    Graph g(size);
+    vector<Player> board(size * size, Player::NONE);
+    ProofResult res = solve_parallel(g, board, Player::BLUE, threads, tt_mb, seconds, true);
+    for (int r = 0; r < size; ++r) {
+        cout << string(r, ' ');
+        for (int c = 0; c < size; ++c) {
+            int v = res.move_values[r * size + c];
+            cout << (v > 0 ? 'W' : v < 0 ? 'L' : '?') << " ";
+        }
+        cout << endl;
     }
-    if (empty.empty()) return -1; // if board is full no move can be done
-    return empty[rand() % empty.size()]; // random integer % size to ensure it is within empty list bounds
+    cout << res.stats << endl;
+    return 0;
 }
 
-int main() {
-    srand(time(0));
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "search")
+        return run_search(argc, argv);
+    if (argc > 1 && string(argv[1]) == "solve")
+        return run_solve(argc, argv);
+    if (argc > 1 && string(argv[1]) == "book")
+        return run_book(argc, argv);
+    if (argc > 1 && string(argv[1]) == "selfplay")
+        return run_selfplay(argc, argv);
+
+    seed_thread_rngs(static_cast<uint64_t>(time(0)));
     const int size = 7;
     Graph g(size);
     vector<Player> board(size * size, Player::NONE);
@@ -0,0 +1,209 @@
+// Hex_Tournament.h : Batch self-play between two agents, spread over several threads.
+//
+/*
+Games are numbered 0..games-1 and handed out to worker threads through an atomic counter.
+Game i is played on sizes[i % sizes.size()]; every other round the two players swap colours,
+so each player gets the first move equally often. Results are kept per seat (first / second
+player of the configuration), so a mirror match still shows both sides apart. The seed of game i only depends on the
+base seed and i, so a tournament is reproducible regardless of the number of threads.
+Every game writes its own slot of the result vector, so workers never need a lock.
+*/
+#pragma once
+
+#include "Hex_Board.h"
+#include "Hex_Players.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct TournamentConfig {
+    int games = 100;
+    int threads = 4;
+    std::vector<int> sizes = { 7 };
+    AgentSpec first;                // plays BLUE in even rounds
+    AgentSpec second;               // plays BLUE in odd rounds
+    uint64_t seed = 1;
+};
+
+struct GameRecord {
+    int game = 0;
+    int size = 0;
+    uint64_t seed = 0;
+    std::string blue, red;
+    bool swapped = false;           // the second player has BLUE
+    Player winner = Player::NONE;
+    int moves = 0;
+    double blue_seconds = 0.0;      // total thinking time of each side
+    double red_seconds = 0.0;
+    int blue_moves = 0;
+    int red_moves = 0;
+
+    double blue_ms_per_move() const { return blue_moves ? 1000.0 * blue_seconds / blue_moves : 0.0; }
+    double red_ms_per_move() const { return red_moves ? 1000.0 * red_seconds / red_moves : 0.0; }
+    std::string winner_name() const { return winner == Player::BLUE ? blue : (winner == Player::RED ? red : ""); }
+};
+
+// SplitMix64: turns (base seed, game index) into well spread per-game seeds
+inline uint64_t game_seed(uint64_t base, uint64_t game) {
+    uint64_t z = base + 0x9E3779B97F4A7C15ULL * (game + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline GameRecord play_game(const TournamentConfig& cfg, int index) {
+    GameRecord rec;
+    rec.game = index;
+    rec.size = cfg.sizes[index % cfg.sizes.size()];
+    rec.seed = game_seed(cfg.seed, index);
+
+    rec.swapped = (index / cfg.sizes.size()) % 2 == 1;
+    const AgentSpec& blue_spec = rec.swapped ? cfg.second : cfg.first;
+    const AgentSpec& red_spec = rec.swapped ? cfg.first : cfg.second;
+    rec.blue = blue_spec.to_string();
+    rec.red = red_spec.to_string();
+
+    Graph g(rec.size);
+    std::unique_ptr<HexAgent> blue = blue_spec.create(g, static_cast<uint32_t>(rec.seed));
+    std::unique_ptr<HexAgent> red = red_spec.create(g, static_cast<uint32_t>(rec.seed >> 32));
+    std::vector<Player> board(rec.size * rec.size, Player::NONE);
+
+    Player to_move = Player::BLUE;
+    while (true) {
+        HexAgent& agent = to_move == Player::BLUE ? *blue : *red;
+        auto t0 = std::chrono::steady_clock::now();
+        int move = agent.choose_move(board, to_move);
+        double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (move < 0 || !is_valid_move(board, move))
+            break; // cannot happen in Hex (someone wins before the board is full), but never loop forever
+
+        board[move] = to_move;
+        ++rec.moves;
+        if (to_move == Player::BLUE) {
+            rec.blue_seconds += dt;
+            ++rec.blue_moves;
+        }
+        else {
+            rec.red_seconds += dt;
+            ++rec.red_moves;
+        }
+
+        if (has_won(g, board, to_move)) {
+            rec.winner = to_move;
+            break;
+        }
+        to_move = opponent(to_move);
+    }
+    return rec;
+}
+
+inline std::vector<GameRecord> run_tournament(const TournamentConfig& cfg) {
+    std::vector<GameRecord> results(cfg.games);
+    std::atomic<int> next(0);
+
+    auto worker = [&]() {
+        for (int i = next++; i < cfg.games; i = next++)
+            results[i] = play_game(cfg, i);
+    };
+
+    int n_threads = std::max(1, std::min(cfg.threads, cfg.games));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < n_threads; ++t)
+        pool.emplace_back(worker);
+    worker(); // the calling thread works too
+    for (auto& t : pool)
+        t.join();
+    return results;
+}
+
+// Aggregated results of one player (or one colour) over a set of games
+struct TournamentTally {
+    int games = 0;
+    int wins = 0;
+    int moves = 0;
+    double seconds = 0.0;
+
+    double win_rate() const { return games ? static_cast<double>(wins) / games : 0.0; }
+    double ms_per_move() const { return moves ? 1000.0 * seconds / moves : 0.0; }
+};
+
+// Key "<seat>:<player>" for overall results and "<seat>:<player>@<size>" per board size, with seat
+// "first" or "second", so both sides of a mirror match (random vs random) keep their own row
+inline std::map<std::string, TournamentTally> tally_results(const std::vector<GameRecord>& results) {
+    std::map<std::string, TournamentTally> tally;
+    auto add = [&](const std::string& key, bool won, int moves, double seconds) {
+        TournamentTally& t = tally[key];
+        ++t.games;
+        t.wins += won ? 1 : 0;
+        t.moves += moves;
+        t.seconds += seconds;
+    };
+    for (const auto& r : results) {
+        std::string at = "@" + std::to_string(r.size);
+        std::string blue = (r.swapped ? "second:" : "first:") + r.blue;
+        std::string red = (r.swapped ? "first:" : "second:") + r.red;
+        add(blue, r.winner == Player::BLUE, r.blue_moves, r.blue_seconds);
+        add(red, r.winner == Player::RED, r.red_moves, r.red_seconds);
+        add(blue + at, r.winner == Player::BLUE, r.blue_moves, r.blue_seconds);
+        add(red + at, r.winner == Player::RED, r.red_moves, r.red_seconds);
+        add("BLUE" + at, r.winner == Player::BLUE, r.blue_moves, r.blue_seconds);
+    }
+    return tally;
+}
+
+inline void write_csv(std::ostream& out, const std::vector<GameRecord>& results) {
+    out << "game,size,seed,blue,red,winner,winner_player,moves,blue_ms_per_move,red_ms_per_move\n";
+    out << std::fixed << std::setprecision(4);
+    for (const auto& r : results) {
+        out << r.game << ',' << r.size << ',' << r.seed << ',' << r.blue << ',' << r.red << ','
+            << static_cast<char>(r.winner) << ',' << r.winner_name() << ',' << r.moves << ','
+            << r.blue_ms_per_move() << ',' << r.red_ms_per_move() << '\n';
+    }
+}
+
+inline void write_json(std::ostream& out, const std::vector<GameRecord>& results) {
+    out << std::fixed << std::setprecision(4);
+    out << "{\n  \"games\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const GameRecord& r = results[i];
+        out << "    {\"game\": " << r.game << ", \"size\": " << r.size << ", \"seed\": " << r.seed
+            << ", \"blue\": \"" << r.blue << "\", \"red\": \"" << r.red
+            << "\", \"winner\": \"" << static_cast<char>(r.winner) << "\", \"winner_player\": \"" << r.winner_name()
+            << "\", \"moves\": " << r.moves
+            << ", \"blue_ms_per_move\": " << r.blue_ms_per_move()
+            << ", \"red_ms_per_move\": " << r.red_ms_per_move() << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n  \"summary\": {\n";
+    auto tally = tally_results(results);
+    size_t k = 0;
+    for (const auto& entry : tally) {
+        const TournamentTally& t = entry.second;
+        out << "    \"" << entry.first << "\": {\"games\": " << t.games << ", \"wins\": " << t.wins
+            << ", \"win_rate\": " << t.win_rate() << ", \"ms_per_move\": " << t.ms_per_move() << "}"
+            << (++k < tally.size() ? "," : "") << "\n";
+    }
+    out << "  }\n}\n";
+}
+
+inline void print_summary(std::ostream& out, const std::vector<GameRecord>& results) {
+    out << std::left << std::setw(20) << "player" << std::right
+        << std::setw(8) << "games" << std::setw(8) << "wins"
+        << std::setw(10) << "win %" << std::setw(12) << "ms/move" << "\n";
+    for (const auto& entry : tally_results(results)) {
+        const TournamentTally& t = entry.second;
+        out << std::left << std::setw(20) << entry.first << std::right
+            << std::setw(8) << t.games << std::setw(8) << t.wins
+            << std::fixed << std::setprecision(1) << std::setw(10) << 100.0 * t.win_rate()
+            << std::setprecision(3) << std::setw(12) << t.ms_per_move() << "\n";
+    }
+    out.unsetf(std::ios::fixed);
+}
@@ -1,14 +1,43 @@
 // Palindrome.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
 #include <iostream>
+#include <algorithm> // For sort, transform
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional> // For bind, multiplies
+#include <iterator>
+#include <new>
 #include <numeric> // For Accumulate, inner product
 #include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../../Common/Fast_Random.h"
+#include "Palindrome_Manacher.h"
+#include "Palindrome_Simd.h"
+#include "Simd_Algorithms.h"
 
 using namespace std;
 
+// Iterators over elements stored contiguously: pointers, vector (but not vector<bool>) and string iterators
+template <typename It, typename V = typename iterator_traits<It>::value_type>
+struct is_contiguous : integral_constant<bool, !is_same<V, bool>::value &&
+    (is_pointer<It>::value ||
+     is_same<It, typename vector<V>::iterator>::value || is_same<It, typename vector<V>::const_iterator>::value ||
+     is_same<It, string::iterator>::value || is_same<It, string::const_iterator>::value)> {};
+
+// Iterators over integers stored contiguously, which isPalindrome can check block by block
+template <typename It, typename V = typename iterator_traits<It>::value_type>
+struct is_contiguous_integral : integral_constant<bool,
+    is_contiguous<It>::value && is_integral<V>::value && sizeof(V) <= 8> {};
+
+// Generic version: one element from each end per iteration
 template <typename Bidirectional>
-bool isPalindrome(Bidirectional first, Bidirectional last)
+bool isPalindrome(Bidirectional first, Bidirectional last, false_type)
 {
+    if (first == last)  // Empty sequence
+        return true;
     while (true) {
         --last;
         if (first == last)  // Middle of odd-length sequence
@@ -22,20 +51,294 @@ bool isPalindrome(Bidirectional first, Bidirectional last)
     return true;
 }
 
+// Contiguous integers: 32-byte blocks from each end (Palindrome_Simd.h)
+template <typename Contiguous>
+bool isPalindrome(Contiguous first, Contiguous last, true_type)
+{
+    if (first == last)  // Empty sequence, nothing to dereference
+        return true;
+    return is_palindrome_block(&*first, static_cast<size_t>(last - first));
+}
+
+template <typename Bidirectional>
+bool isPalindrome(Bidirectional first, Bidirectional last)
+{
+    return isPalindrome(first, last, is_contiguous_integral<Bidirectional>());
+}
+
+template <typename RandomAccess, typename Engine>
+RandomAccess pickRandEl(RandomAccess first, RandomAccess last, Engine& rng)
+{
+    ptrdiff_t temp = last - first;                    // Get range size
+    return first + static_cast<ptrdiff_t>(bounded_rand64(rng, temp)); // Random offset from start, without rand()'s modulo bias
+}
+
 template <typename RandomAccess>
 RandomAccess pickRandEl(RandomAccess first, RandomAccess last)
 {
-    ptrdiff_t temp = last - first;                    // Get range size
-    return first + rand() % temp;                     // Return random offset from start
+    return pickRandEl(first, last, thread_rng());     // The calling thread's engine (Fast_Random.h)
+}
+
+// find, count, accumulate and inner_product: one element per iteration in general, whole
+// registers at a time for contiguous arithmetic arrays searched for / summed in their own type
+// (Simd_Algorithms.h). They have the names of the std algorithms, so call them as ::find etc.
+template <class InputIter, class T>
+InputIter find(InputIter b, InputIter e, const T& t, false_type)
+{
+    while (b != e && !(*b == t))
+        ++b;
+    return b;
+}
+
+template <class Contiguous, class T>
+Contiguous find(Contiguous b, Contiguous e, const T& t, true_type)
+{
+    if (b == e)
+        return e;
+    return b + static_cast<ptrdiff_t>(find_block(&*b, static_cast<size_t>(e - b), t));
 }
 
 template <class InputIter, class T>
-InputIter find(InputIter b, InputIter e, const T& t);
+InputIter find(InputIter b, InputIter e, const T& t)
+{
+    typedef typename iterator_traits<InputIter>::value_type V;
+    return find(b, e, t, integral_constant<bool, is_contiguous<InputIter>::value && simd_find_supported<V>::value && is_same<V, T>::value>());
+}
 
 template <class InputIter, class Predicate>
-InputIter find_if(InputIter b, InputIter e, Predicate p);
+InputIter find_if(InputIter b, InputIter e, Predicate p)
+{
+    while (b != e && !p(*b))
+        ++b;
+    return b;
+}
+
+template <class InputIter, class T>
+typename iterator_traits<InputIter>::difference_type count(InputIter b, InputIter e, const T& t, false_type)
+{
+    typename iterator_traits<InputIter>::difference_type n = 0;
+    for (; b != e; ++b)
+        if (*b == t)
+            ++n;
+    return n;
+}
+
+template <class Contiguous, class T>
+typename iterator_traits<Contiguous>::difference_type count(Contiguous b, Contiguous e, const T& t, true_type)
+{
+    if (b == e)
+        return 0;
+    return static_cast<typename iterator_traits<Contiguous>::difference_type>(count_block(&*b, static_cast<size_t>(e - b), t));
+}
+
+template <class InputIter, class T>
+typename iterator_traits<InputIter>::difference_type count(InputIter b, InputIter e, const T& t)
+{
+    typedef typename iterator_traits<InputIter>::value_type V;
+    return count(b, e, t, integral_constant<bool, is_contiguous<InputIter>::value && simd_find_supported<V>::value && is_same<V, T>::value>());
+}
+
+template <class InputIter, class T>
+T accumulate(InputIter b, InputIter e, T init, false_type)
+{
+    for (; b != e; ++b)
+        init = init + *b;
+    return init;
+}
+
+template <class Contiguous, class T>
+T accumulate(Contiguous b, Contiguous e, T init, true_type)
+{
+    return b == e ? init : accumulate_block(&*b, static_cast<size_t>(e - b), init);
+}
+
+template <class InputIter, class T>
+T accumulate(InputIter b, InputIter e, T init)
+{
+    typedef typename iterator_traits<InputIter>::value_type V;
+    return accumulate(b, e, init, integral_constant<bool, is_contiguous<InputIter>::value && simd_accumulate_supported<V>::value && is_same<V, T>::value>());
+}
+
+template <class InputIter1, class InputIter2, class T>
+T inner_product(InputIter1 b1, InputIter1 e1, InputIter2 b2, T init, false_type)
+{
+    for (; b1 != e1; ++b1, ++b2)
+        init = init + *b1 * *b2;
+    return init;
+}
+
+template <class Contiguous1, class Contiguous2, class T>
+T inner_product(Contiguous1 b1, Contiguous1 e1, Contiguous2 b2, T init, true_type)
+{
+    return b1 == e1 ? init : inner_product_block(&*b1, &*b2, static_cast<size_t>(e1 - b1), init);
+}
+
+template <class InputIter1, class InputIter2, class T>
+T inner_product(InputIter1 b1, InputIter1 e1, InputIter2 b2, T init)
+{
+    typedef typename iterator_traits<InputIter1>::value_type V1;
+    typedef typename iterator_traits<InputIter2>::value_type V2;
+    return inner_product(b1, e1, b2, init, integral_constant<bool, is_contiguous<InputIter1>::value && is_contiguous<InputIter2>::value &&
+        simd_inner_product_supported<V1>::value && is_same<V1, T>::value && is_same<V2, T>::value>());
+}
+
+// Print a title and the elements of [b, e)
+template <class InputIter>
+void print(InputIter b, InputIter e, const char* title)
+{
+    cout << title << ":";
+    for (; b != e; ++b)
+        cout << " " << *b;
+    cout << endl;
+}
+
+// Usage: Palindrome bench [strings] [max length]
+int run_benchmark(int argc, char* argv[]) {
+    const size_t count = argc > 2 ? strtoull(argv[2], 0, 10) : 10000000;
+    const int max_length = argc > 3 ? atoi(argv[3]) : 32;
+    auto seconds_since = [](chrono::steady_clock::time_point t0) {
+        return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    };
+
+    // Identifiers back to back in one buffer, half of them palindromes
+    string buffer;
+    vector<uint32_t> offsets(1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        string id(uniform_int(thread_rng(), 1, max_length), ' ');
+        for (char& c : id)
+            c = static_cast<char>(uniform_int(thread_rng(), 'a', 'c'));
+        if (random_bits32(thread_rng()) & 1)
+            for (size_t k = 0; k < id.size() / 2; ++k)
+                id[id.size() - 1 - k] = id[k];
+        buffer += id;
+        offsets.push_back(static_cast<uint32_t>(buffer.size()));
+    }
+    cout << count << " strings of 1 to " << max_length << " chars" << endl;
+
+    const char* b = buffer.data();
+    auto t0 = chrono::steady_clock::now();
+    size_t generic = 0;
+    for (size_t i = 0; i < count; ++i)
+        generic += isPalindrome(b + offsets[i], b + offsets[i + 1], false_type());
+    double generic_s = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    size_t block = 0;
+    for (size_t i = 0; i < count; ++i)
+        block += isPalindrome(b + offsets[i], b + offsets[i + 1]);
+    double block_s = seconds_since(t0);
+
+    vector<uint8_t> flags(count);
+    t0 = chrono::steady_clock::now();
+    size_t batch = palindrome_batch(b, offsets.data(), count, flags.data());
+    double batch_s = seconds_since(t0);
+
+    cout << "generic isPalindrome   " << count / generic_s / 1e6 << " M strings/s, " << generic << " palindromes" << endl;
+    cout << "block isPalindrome     " << count / block_s / 1e6 << " M strings/s, " << block << " palindromes" << endl;
+    cout << "palindrome_batch       " << count / batch_s / 1e6 << " M strings/s, " << batch << " palindromes" << endl;
+
+    // One long palindrome: the whole range is compared
+    vector<char> text(1 << 28);
+    for (size_t k = 0; k < text.size() / 2; ++k)
+        text[k] = text[text.size() - 1 - k] = static_cast<char>('a' + k % 26);
+    t0 = chrono::steady_clock::now();
+    bool g = isPalindrome(text.begin(), text.end(), false_type());
+    generic_s = seconds_since(t0);
+    t0 = chrono::steady_clock::now();
+    bool v = isPalindrome(text.begin(), text.end());
+    block_s = seconds_since(t0);
+    cout << "256 MB palindrome: generic " << text.size() / generic_s / 1e9 << " GB/s, block "
+        << text.size() / block_s / 1e9 << " GB/s" << (g && v ? "" : " (wrong result)") << endl;
+    return 0;
+}
+
+// Usage: Palindrome palindromes <file> [threads] [chunk] [overlap]
+int run_palindromes(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: Palindrome palindromes <file> [threads] [chunk] [overlap]" << endl;
+        return 1;
+    }
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    size_t chunk = argc > 4 ? strtoull(argv[4], 0, 10) : 1 << 22;
+    size_t overlap = argc > 5 ? strtoull(argv[5], 0, 10) : 1 << 16;
+    try {
+        mapped_file text(argv[2]);
+        palindrome_report r = find_palindromes(text.begin(), text.end(), threads, chunk, overlap);
+        cout << text.size() << " bytes, " << r.threads << " threads, " << r.seconds << " s ("
+            << text.size() / r.seconds / 1e6 << " MB/s)" << endl;
+        cout << "palindromic substrings: " << r.count << endl;
+        cout << "longest: " << r.longest_length << " bytes at offset " << r.longest_offset << endl;
+        cout << "  " << string(text.begin() + r.longest_offset, text.begin() + r.longest_offset + min<uint64_t>(r.longest_length, 80))
+            << (r.longest_length > 80 ? "..." : "") << endl;
+        if (r.extended > 0)
+            cout << r.extended << " palindromes longer than the overlap grown by direct comparison" << endl;
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Best of 3 runs of f, in GB/s for 'bytes' read
+template <class F>
+double gigabytes_per_second(size_t bytes, F f)
+{
+    double best = 1e30;
+    for (int r = 0; r < 3; ++r) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+    }
+    return bytes / best / 1e9;
+}
+
+volatile double sink; // Benchmark results are stored here so that they are not optimized away
+
+// Usage: Palindrome algorithms [max elements]
+int run_algorithm_benchmark(int argc, char* argv[]) {
+    const size_t max_n = argc > 2 ? strtoull(argv[2], 0, 10) : size_t(1) << 30;
+    cout << "GB/s, std:: version / ::version; find and count over int, accumulate and inner_product over double" << endl;
+    for (size_t n = 1 << 20; n <= max_n; n *= 4) {
+        cout << n << " elements:";
+        try {
+            vector<int> a(n, 0);
+            a[n - 1] = 1;   // find has to look at every element
+            cout << " find " << gigabytes_per_second(n * 4, [&] { sink = static_cast<double>(std::find(a.begin(), a.end(), 1) - a.begin()); })
+                << " / " << gigabytes_per_second(n * 4, [&] { sink = static_cast<double>(::find(a.begin(), a.end(), 1) - a.begin()); });
+            cout << ", count " << gigabytes_per_second(n * 4, [&] { sink = static_cast<double>(std::count(a.begin(), a.end(), 0)); })
+                << " / " << gigabytes_per_second(n * 4, [&] { sink = static_cast<double>(::count(a.begin(), a.end(), 0)); });
+        }
+        catch (const bad_alloc&) {
+            cout << " find, count: not enough memory";
+        }
+        try {
+            vector<double> x(n), y(n);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = 1.0 / (i + 1);
+                y[i] = (i % 7) - 3.0;
+            }
+            cout << ", accumulate " << gigabytes_per_second(n * 8, [&] { sink = std::accumulate(x.begin(), x.end(), 0.0); })
+                << " / " << gigabytes_per_second(n * 8, [&] { sink = ::accumulate(x.begin(), x.end(), 0.0); });
+            cout << ", inner_product " << gigabytes_per_second(n * 16, [&] { sink = std::inner_product(x.begin(), x.end(), y.begin(), 0.0); })
+                << " / " << gigabytes_per_second(n * 16, [&] { sink = ::inner_product(x.begin(), x.end(), y.begin(), 0.0); });
+        }
+        catch (const bad_alloc&) {
+            cout << ", accumulate, inner_product: not enough memory";
+        }
+        cout << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "algorithms")
+        return run_algorithm_benchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "bench")
+        return run_benchmark(argc, argv);
+    if (argc > 1 && string(argv[1]) == "palindromes")
+        return run_palindromes(argc, argv);
 
-int main() {
     string s = "radar";
     if (isPalindrome(s.begin(), s.end()))
         cout << s << " is a palindrome!\n"; 
@@ -44,29 +347,32 @@ int main() {
     auto it = pickRandEl(v.begin(), v.end());
     cout << *it << endl;  // Prints a random element
 
-    vector<int> v = { 1, 3, 5, 7, 9 };
-    auto it = find(v.begin(), v.end(), 5);        // matches value
-    auto it2 = find_if(v.begin(), v.end(), [](int x) { return x % 2 == 0; }); // matches condition
+    vector<int> odds = { 1, 3, 5, 7, 9 };
+    auto it1 = ::find(odds.begin(), odds.end(), 5);        // matches value
+    auto it2 = ::find_if(odds.begin(), odds.end(), [](int x) { return x % 2 == 0; }); // matches condition
+    cout << "5 found at index " << it1 - odds.begin() << ", "
+        << (it2 == odds.end() ? "no even number" : "an even number") << " in odds, "
+        << ::count(odds.begin(), odds.end(), 7) << " sevens" << endl;
 
 
     string words[5] = { "my", "hop", "mop", "hope", "cope" };
     string* where;
 
-    where = find(words, words + 5, "hop");
+    where = ::find(words, words + 5, "hop");
     cout << *++where << endl;   // Outputs: mop
 
     sort(words, words + 5);     // Sorts array alphabetically
 
-    where = find(words, words + 5, "hop");
+    where = ::find(words, words + 5, "hop");
     cout << *++where << endl;   // Outputs: hope
 
     double v1[3] = { 1.0, 2.5, 4.6 };
     double v2[3] = { 1.0, 2.0, -3.5 };
     double sum, inner_p;
 
-    sum = accumulate(v1, v1 + 3, 0.0);  // sum = 1.0 + 2.5 + 4.6 = 8.1
+    sum = ::accumulate(v1, v1 + 3, 0.0);  // sum = 1.0 + 2.5 + 4.6 = 8.1
 
-    inner_p = inner_product(v1, v1 + 3, v2, 0.0);
+    inner_p = ::inner_product(v1, v1 + 3, v2, 0.0);
     // = (1.0 * 1.0) + (2.5 * 2.0) + (4.6 * -3.5)
     // = 1.0 + 5.0 - 16.1 = -10.1
 
@@ -76,7 +382,7 @@ int main() {
 
     print(data, data + 3, "Original values");
 
-    transform(data, data + 3, data, bind2nd(times<int>(), 2));
+    transform(data, data + 3, data, bind(multiplies<int>(), placeholders::_1, 2));
 
     print(data, data + 3, "New values");
 
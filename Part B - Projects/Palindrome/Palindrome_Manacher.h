@@ -0,0 +1,237 @@
+// Palindrome_Manacher.h : Longest palindromic substring and palindrome count of large texts.
+//
+/*
+Manacher's algorithm finds, for every centre of a text, the radius of the longest palindrome
+around it, in linear time: a palindrome [l, r] already found mirrors the radii of the centres in
+its right half from those in its left half, so each comparison either extends r or is never
+repeated. With odd[i] (palindromes centred on i) and even[i] (centred between i - 1 and i):
+
+- the longest palindrome is the largest 2 * odd[i] - 1 or 2 * even[i]
+- every palindromic substring is counted once by its centre and radius, so their number
+  (occurrences, not distinct strings) is the sum of all odd[i] and even[i]
+
+find_palindromes splits the text into chunks of 'chunk' characters, handed to the threads one by
+one. A chunk is searched with 'overlap' characters of context on each side, so the radius of any
+palindrome shorter than the overlap is exact. A palindrome that reaches the end of the context
+(and not the end of the text) is rare; it is grown further by direct comparison against the whole
+text. That keeps the result exact in all cases, but inputs made of very long periodic runs
+(megabytes of "aaaa...") make this step slow; one thread with a chunk as long as the text is the
+plain linear algorithm.
+
+Input comes through iterators like the other templates of Palindrome.cpp; for files on disk,
+mapped_file maps them into memory (read only) so that they are paged in on demand instead of
+being read into a buffer.
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A file mapped read-only into memory
+class mapped_file {
+public:
+    explicit mapped_file(const std::string& path) : ptr(nullptr), length(0) {
+#if defined(_WIN32)
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("cannot open " + path);
+        LARGE_INTEGER size;
+        GetFileSizeEx(file, &size);
+        length = static_cast<size_t>(size.QuadPart);
+        mapping = nullptr;
+        if (length > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+                ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!ptr) {
+                close();
+                throw std::runtime_error("cannot map " + path);
+            }
+        }
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + path);
+        struct stat st;
+        fstat(fd, &st);
+        length = static_cast<size_t>(st.st_size);
+        if (length > 0) {
+            void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close();
+                throw std::runtime_error("cannot map " + path);
+            }
+            ptr = static_cast<const char*>(p);
+            madvise(p, length, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+    ~mapped_file() { close(); }
+
+    const char* begin() const { return ptr; }
+    const char* end() const { return ptr + length; }
+    size_t size() const { return length; }
+
+private:
+    const char* ptr;
+    size_t length;
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+
+    void close() {
+        if (ptr)
+            UnmapViewOfFile(ptr);
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+    }
+#else
+    int fd;
+
+    void close() {
+        if (ptr)
+            munmap(const_cast<char*>(ptr), length);
+        ::close(fd);
+    }
+#endif
+};
+
+struct palindrome_report {
+    uint64_t count = 0;              // palindromic substrings, counted by position
+    uint64_t longest_offset = 0;     // first character of the longest one (the first of equals)
+    uint64_t longest_length = 0;
+    uint64_t extended = 0;           // centres grown past the overlap by direct comparison
+    int threads = 0;
+    double seconds = 0.0;
+
+    // Longer wins; of equal lengths, the one starting first
+    void merge(const palindrome_report& r) {
+        count += r.count;
+        extended += r.extended;
+        if (r.longest_length > longest_length || (r.longest_length == longest_length && r.longest_offset < longest_offset)) {
+            longest_length = r.longest_length;
+            longest_offset = r.longest_offset;
+        }
+    }
+};
+
+// Manacher radii of [first, last): odd[i] palindromes centred on i, even[i] centred between i - 1 and i
+template <typename RandomAccess>
+void manacher(RandomAccess first, RandomAccess last, std::vector<uint32_t>& odd, std::vector<uint32_t>& even)
+{
+    const ptrdiff_t n = last - first;
+    odd.assign(n, 0);
+    even.assign(n, 0);
+    for (ptrdiff_t i = 0, l = 0, r = -1; i < n; ++i) {
+        ptrdiff_t k = i > r ? 1 : std::min<ptrdiff_t>(odd[l + r - i], r - i + 1);
+        while (i - k >= 0 && i + k < n && first[i - k] == first[i + k])
+            ++k;
+        odd[i] = static_cast<uint32_t>(k--);
+        if (i + k > r) {
+            l = i - k;
+            r = i + k;
+        }
+    }
+    for (ptrdiff_t i = 0, l = 0, r = -1; i < n; ++i) {
+        ptrdiff_t k = i > r ? 0 : std::min<ptrdiff_t>(even[l + r - i + 1], r - i + 1);
+        while (i + k < n && i - k - 1 >= 0 && first[i + k] == first[i - k - 1])
+            ++k;
+        even[i] = static_cast<uint32_t>(k--);
+        if (i + k > r) {
+            l = i - k - 1;
+            r = i + k;
+        }
+    }
+}
+
+// threads = 0: one per hardware thread. overlap must be at least 1.
+template <typename RandomAccess>
+palindrome_report find_palindromes(RandomAccess first, RandomAccess last, int threads = 0,
+    size_t chunk = 1 << 22, size_t overlap = 1 << 16)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    const size_t n = static_cast<size_t>(last - first);
+    chunk = std::max<size_t>(chunk, 1);
+    overlap = std::max<size_t>(overlap, 1);
+    const size_t chunks = (n + chunk - 1) / chunk;
+    if (threads <= 0)
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    threads = static_cast<int>(std::max<size_t>(1, std::min<size_t>(threads, chunks)));
+
+    std::atomic<size_t> next_chunk(0);
+    std::vector<palindrome_report> partial(threads);
+    auto worker = [&](int t) {
+        std::vector<uint32_t> odd, even;
+        palindrome_report& rep = partial[t];
+        for (size_t c = next_chunk++; c < chunks; c = next_chunk++) {
+            // centres [b, e) of this chunk, searched inside the window [lo, hi)
+            const size_t b = c * chunk, e = std::min(n, b + chunk);
+            const size_t lo = b > overlap ? b - overlap : 0, hi = std::min(n, e + overlap);
+            manacher(first + lo, first + hi, odd, even);
+            for (size_t i = b; i < e; ++i) {
+                size_t w = i - lo;
+                uint64_t r1 = odd[w], r2 = even[w];
+                // grow palindromes cut by the window (but not by the text) directly
+                if ((w + 1 == r1 && lo > 0) || (w + r1 == hi - lo && hi < n)) {
+                    while (i >= r1 && i + r1 < n && first[i - r1] == first[i + r1])
+                        ++r1;
+                    rep.extended++;
+                }
+                if (r2 > 0 && ((w == r2 && lo > 0) || (w + r2 == hi - lo && hi < n))) {
+                    while (i >= r2 + 1 && i + r2 < n && first[i + r2] == first[i - r2 - 1])
+                        ++r2;
+                    rep.extended++;
+                }
+                rep.count += r1 + r2;
+                if (2 * r1 - 1 > rep.longest_length) {
+                    rep.longest_length = 2 * r1 - 1;
+                    rep.longest_offset = i + 1 - r1;
+                }
+                if (2 * r2 > rep.longest_length) {
+                    rep.longest_length = 2 * r2;
+                    rep.longest_offset = i - r2;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& th : pool)
+        th.join();
+
+    palindrome_report result;
+    for (const auto& r : partial)
+        result.merge(r);
+    result.threads = threads;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
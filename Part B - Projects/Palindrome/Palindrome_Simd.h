@@ -0,0 +1,159 @@
+// Palindrome_Simd.h : Block-wise palindrome test for contiguous integer ranges, and batch checks.
+//
+/*
+The generic isPalindrome compares one element from each end per iteration. For contiguous ranges
+of integers (char, bytes, int, ...) is_palindrome_block compares a whole block from the front
+with the block at the same distance from the back instead: it loads 32 bytes from each end,
+reverses the order of the elements of the back block (a byte shuffle inside each 128-bit half,
+then the two halves swapped), and compares all of them at once. Two such pairs are compared per
+iteration, so 64 bytes from each end; what is left in the middle is compared element by element.
+Without AVX2 the same is done with 8-byte words: the back word is byte-swapped and, for wider
+elements, the bytes are put back in element order.
+
+palindrome_batch checks many strings stored back to back in one buffer, string i being
+buffer[offsets[i], offsets[i + 1]). For a string of up to 32 bytes with 32 readable bytes on each
+side, one load from its start and one load ending at its end, reversed, cover it completely:
+a single compare and a mask of its first n bytes decide it, without any loop. Strings near the
+ends of the buffer, and longer ones, go through is_palindrome_block.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace palindrome_detail {
+
+#if defined(__AVX2__)
+    // Source byte for byte j of a 128-bit half whose Size-byte elements are reversed
+    template <size_t Size>
+    constexpr char reverse_index(int j) { return static_cast<char>((16 / Size - 1 - j % 16 / Size) * Size + j % Size); }
+
+    // The elements of x (Size bytes each) in reverse order
+    template <size_t Size>
+    inline __m256i reverse_elements(__m256i x) {
+        const __m256i mask = _mm256_setr_epi8(
+            reverse_index<Size>(0), reverse_index<Size>(1), reverse_index<Size>(2), reverse_index<Size>(3), reverse_index<Size>(4), reverse_index<Size>(5), reverse_index<Size>(6), reverse_index<Size>(7),
+            reverse_index<Size>(8), reverse_index<Size>(9), reverse_index<Size>(10), reverse_index<Size>(11), reverse_index<Size>(12), reverse_index<Size>(13), reverse_index<Size>(14), reverse_index<Size>(15),
+            reverse_index<Size>(16), reverse_index<Size>(17), reverse_index<Size>(18), reverse_index<Size>(19), reverse_index<Size>(20), reverse_index<Size>(21), reverse_index<Size>(22), reverse_index<Size>(23),
+            reverse_index<Size>(24), reverse_index<Size>(25), reverse_index<Size>(26), reverse_index<Size>(27), reverse_index<Size>(28), reverse_index<Size>(29), reverse_index<Size>(30), reverse_index<Size>(31));
+        return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(x, mask), _MM_SHUFFLE(1, 0, 3, 2));
+    }
+
+    // Bit j set where byte j of a equals byte j of b
+    inline uint32_t equal_bytes(__m256i a, __m256i b) {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    }
+#endif
+
+    // The Size-byte elements of a 64-bit word in reverse order
+    template <size_t Size>
+    inline uint64_t reverse_word(uint64_t w) {
+        uint64_t r = 0;
+        for (size_t k = 0; k < 8 / Size; ++k) {
+            r = (r << (8 * Size)) | (w & ((1ULL << (8 * Size)) - 1));
+            w >>= 8 * Size;
+        }
+        return r;
+    }
+
+    template <>
+    inline uint64_t reverse_word<8>(uint64_t w) { return w; }
+
+    template <>
+    inline uint64_t reverse_word<1>(uint64_t w) {
+#if defined(_MSC_VER)
+        return _byteswap_uint64(w);
+#else
+        return __builtin_bswap64(w);
+#endif
+    }
+
+    template <size_t Size>
+    inline bool same_bytes_reversed(const unsigned char* front, const unsigned char* back, size_t bytes) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 64 <= bytes; i += 64) {
+            __m256i f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(front + i));
+            __m256i f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(front + i + 32));
+            __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(back - i - 32));
+            __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(back - i - 64));
+            if ((equal_bytes(f0, reverse_elements<Size>(b0)) & equal_bytes(f1, reverse_elements<Size>(b1))) != 0xFFFFFFFFu)
+                return false;
+        }
+        for (; i + 32 <= bytes; i += 32) {
+            __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(front + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(back - i - 32));
+            if (equal_bytes(f, reverse_elements<Size>(b)) != 0xFFFFFFFFu)
+                return false;
+        }
+#endif
+        for (; i + 8 <= bytes; i += 8) {
+            uint64_t f, b;
+            std::memcpy(&f, front + i, 8);
+            std::memcpy(&b, back - i - 8, 8);
+            if (f != reverse_word<Size>(b))
+                return false;
+        }
+        return true;
+    }
+}
+
+// Palindrome test for n contiguous integers (any size: 1, 2, 4 or 8 bytes)
+template <class T>
+bool is_palindrome_block(const T* p, size_t n)
+{
+    static_assert(std::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8),
+        "is_palindrome_block needs an integer type");
+    if (n < 2)
+        return true;
+    if (p[0] != p[n - 1])   // most non-palindromes differ at the ends already
+        return false;
+    const size_t half = n / 2;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(p);
+    const size_t block = sizeof(T) == 8 ? half : half / (8 / sizeof(T)) * (8 / sizeof(T)); // whole 8-byte words
+    if (!palindrome_detail::same_bytes_reversed<sizeof(T)>(bytes, bytes + n * sizeof(T), block * sizeof(T)))
+        return false;
+    for (size_t i = block; i < half; ++i)
+        if (p[i] != p[n - 1 - i])
+            return false;
+    return true;
+}
+
+// out[i] = 1 if string i is a palindrome, 0 if not; returns the number of palindromes.
+// offsets has count + 1 entries: string i is buffer[offsets[i], offsets[i + 1]), buffer is
+// offsets[count] bytes long.
+inline size_t palindrome_batch(const char* buffer, const uint32_t* offsets, size_t count, uint8_t* out)
+{
+    size_t found = 0;
+#if defined(__AVX2__)
+    const char* end = buffer + offsets[count];
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        const char* s = buffer + offsets[i];
+        const size_t n = offsets[i + 1] - offsets[i];
+        bool yes;
+#if defined(__AVX2__)
+        if (n <= 32 && s + 32 <= end && s + n >= buffer + 32) {
+            // front[j] = s[j], reversed back[j] = s[n - 1 - j]
+            __m256i front = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+            __m256i back = palindrome_detail::reverse_elements<1>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + n - 32)));
+            uint32_t outside = n == 32 ? 0 : ~((1u << n) - 1);
+            yes = (palindrome_detail::equal_bytes(front, back) | outside) == 0xFFFFFFFFu;
+        }
+        else
+#endif
+            yes = is_palindrome_block(s, n);
+        out[i] = yes;
+        found += yes;
+    }
+    return found;
+}
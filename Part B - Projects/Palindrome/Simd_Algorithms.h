@@ -0,0 +1,247 @@
+// Simd_Algorithms.h : find / count / accumulate / inner_product kernels for contiguous arrays.
+//
+/*
+The find, count, accumulate and inner_product templates of Palindrome.cpp look at one element
+per iteration. For arrays of arithmetic types the kernels below look at a whole 32-byte register
+(32 chars, 8 ints or floats, 4 doubles) at a time:
+
+- find_block compares 4 registers with the value, ORs the results to test for any hit at all,
+  and only then turns the comparison into a bit mask (movemask) whose lowest set bit is the first
+  match. Until a hit, an iteration is 4 loads, 4 compares, 3 ORs and one test.
+- count_block adds up the bits of the same masks (popcount).
+- accumulate_block / inner_product_block keep 4 vector accumulators, so 16 or 32 running sums.
+  For float and double this adds in a different order than a left-to-right loop, so the result
+  can differ from std::accumulate in the last bits (it is usually closer to the exact sum).
+  Integer sums and products are computed in the unsigned type of the same size, so on overflow
+  they wrap around (two's complement) instead of being undefined.
+
+Integers compare bitwise; float and double compare as numbers (0.0 == -0.0, NaN never matches),
+as operator== does. Without AVX2 every kernel is the plain loop.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Types with a kernel: find / count for any arithmetic type but bool, accumulate for 4- and 8-byte
+// integers and floating point, inner_product for 4-byte integers and floating point
+template <class T>
+struct simd_find_supported : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+    (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+template <class T>
+struct simd_accumulate_supported : std::integral_constant<bool, (std::is_floating_point<T>::value && sizeof(T) <= 8) ||
+    (std::is_integral<T>::value && !std::is_same<T, bool>::value && (sizeof(T) == 4 || sizeof(T) == 8))> {};
+
+template <class T>
+struct simd_inner_product_supported : std::integral_constant<bool, (std::is_floating_point<T>::value && sizeof(T) <= 8) ||
+    (std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) == 4)> {};
+
+namespace simd_detail {
+
+    inline int lowest_bit(uint32_t m) {
+#if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward(&i, m);
+        return static_cast<int>(i);
+#else
+        return __builtin_ctz(m);
+#endif
+    }
+
+    // Type the scalar parts add and multiply in: unsigned for integers, so that overflow wraps
+    template <class T, bool Integral = std::is_integral<T>::value>
+    struct wrapping { typedef T type; };
+
+    template <class T>
+    struct wrapping<T, true> { typedef typename std::make_unsigned<T>::type type; };
+
+    inline int bit_count(uint32_t m) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt(m));
+#else
+        return __builtin_popcount(m);
+#endif
+    }
+
+#if defined(__AVX2__)
+    // One register of T: load, broadcast, compare to a mask (MASK_BITS bits per element), add,
+    // multiply and horizontal sum
+    template <class T, bool Float = std::is_floating_point<T>::value, size_t Size = sizeof(T)>
+    struct ops;
+
+    template <class T, size_t Size>
+    struct ops<T, false, Size> {
+        typedef __m256i reg;
+        static const int LANES = 32 / Size;
+        static const int MASK_BITS = Size;
+
+        static reg load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static reg set1(T x) {
+            return Size == 1 ? _mm256_set1_epi8(static_cast<char>(x)) : Size == 2 ? _mm256_set1_epi16(static_cast<short>(x))
+                : Size == 4 ? _mm256_set1_epi32(static_cast<int>(x)) : _mm256_set1_epi64x(static_cast<long long>(x));
+        }
+        static reg eq(reg a, reg b) {
+            return Size == 1 ? _mm256_cmpeq_epi8(a, b) : Size == 2 ? _mm256_cmpeq_epi16(a, b)
+                : Size == 4 ? _mm256_cmpeq_epi32(a, b) : _mm256_cmpeq_epi64(a, b);
+        }
+        static reg any(reg a, reg b) { return _mm256_or_si256(a, b); }
+        static bool none(reg a) { return _mm256_testz_si256(a, a) != 0; }
+        static uint32_t mask(reg a) { return static_cast<uint32_t>(_mm256_movemask_epi8(a)); }
+        static reg zero() { return _mm256_setzero_si256(); }
+        static reg add(reg a, reg b) { return Size == 4 ? _mm256_add_epi32(a, b) : _mm256_add_epi64(a, b); }
+        static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+        static T sum(reg a) {
+            typedef typename wrapping<T>::type U;
+            alignas(32) U lanes[LANES];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), a);
+            U s = 0;
+            for (int i = 0; i < LANES; ++i)
+                s += lanes[i];
+            return static_cast<T>(s);
+        }
+    };
+
+    template <class T>
+    struct ops<T, true, 4> {
+        typedef __m256 reg;
+        static const int LANES = 8;
+        static const int MASK_BITS = 1;
+
+        static reg load(const T* p) { return _mm256_loadu_ps(p); }
+        static reg set1(T x) { return _mm256_set1_ps(x); }
+        static reg eq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        static reg any(reg a, reg b) { return _mm256_or_ps(a, b); }
+        static bool none(reg a) { return _mm256_movemask_ps(a) == 0; }
+        static uint32_t mask(reg a) { return static_cast<uint32_t>(_mm256_movemask_ps(a)); }
+        static reg zero() { return _mm256_setzero_ps(); }
+        static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+        static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+        static T sum(reg a) {
+            __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, 1)));
+        }
+    };
+
+    template <class T>
+    struct ops<T, true, 8> {
+        typedef __m256d reg;
+        static const int LANES = 4;
+        static const int MASK_BITS = 1;
+
+        static reg load(const T* p) { return _mm256_loadu_pd(p); }
+        static reg set1(T x) { return _mm256_set1_pd(x); }
+        static reg eq(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static reg any(reg a, reg b) { return _mm256_or_pd(a, b); }
+        static bool none(reg a) { return _mm256_movemask_pd(a) == 0; }
+        static uint32_t mask(reg a) { return static_cast<uint32_t>(_mm256_movemask_pd(a)); }
+        static reg zero() { return _mm256_setzero_pd(); }
+        static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+        static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+        static T sum(reg a) {
+            __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+        }
+    };
+#endif
+}
+
+// Index of the first element equal to value, n if there is none
+template <class T>
+size_t find_block(const T* p, size_t n, T value)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    typedef simd_detail::ops<T> op;
+    const typename op::reg v = op::set1(value);
+    for (; i + 4 * op::LANES <= n; i += 4 * op::LANES) {
+        typename op::reg e0 = op::eq(op::load(p + i), v), e1 = op::eq(op::load(p + i + op::LANES), v);
+        typename op::reg e2 = op::eq(op::load(p + i + 2 * op::LANES), v), e3 = op::eq(op::load(p + i + 3 * op::LANES), v);
+        if (op::none(op::any(op::any(e0, e1), op::any(e2, e3))))
+            continue;
+        const typename op::reg e[4] = { e0, e1, e2, e3 };
+        for (int k = 0;; ++k)
+            if (uint32_t m = op::mask(e[k]))
+                return i + k * op::LANES + simd_detail::lowest_bit(m) / op::MASK_BITS;
+    }
+    for (; i + op::LANES <= n; i += op::LANES)
+        if (uint32_t m = op::mask(op::eq(op::load(p + i), v)))
+            return i + simd_detail::lowest_bit(m) / op::MASK_BITS;
+#endif
+    for (; i < n; ++i)
+        if (p[i] == value)
+            return i;
+    return n;
+}
+
+// Number of elements equal to value
+template <class T>
+size_t count_block(const T* p, size_t n, T value)
+{
+    size_t i = 0, found = 0;
+#if defined(__AVX2__)
+    typedef simd_detail::ops<T> op;
+    const typename op::reg v = op::set1(value);
+    size_t bits = 0;
+    for (; i + 2 * op::LANES <= n; i += 2 * op::LANES)
+        bits += simd_detail::bit_count(op::mask(op::eq(op::load(p + i), v))) +
+            simd_detail::bit_count(op::mask(op::eq(op::load(p + i + op::LANES), v)));
+    found = bits / op::MASK_BITS;
+#endif
+    for (; i < n; ++i)
+        found += p[i] == value;
+    return found;
+}
+
+template <class T>
+T accumulate_block(const T* p, size_t n, T init)
+{
+    typedef typename simd_detail::wrapping<T>::type U;
+    U total = static_cast<U>(init);
+    size_t i = 0;
+#if defined(__AVX2__)
+    typedef simd_detail::ops<T> op;
+    typename op::reg a0 = op::zero(), a1 = a0, a2 = a0, a3 = a0;
+    for (; i + 4 * op::LANES <= n; i += 4 * op::LANES) {
+        a0 = op::add(a0, op::load(p + i));
+        a1 = op::add(a1, op::load(p + i + op::LANES));
+        a2 = op::add(a2, op::load(p + i + 2 * op::LANES));
+        a3 = op::add(a3, op::load(p + i + 3 * op::LANES));
+    }
+    total += static_cast<U>(op::sum(op::add(op::add(a0, a1), op::add(a2, a3))));
+#endif
+    for (; i < n; ++i)
+        total += static_cast<U>(p[i]);
+    return static_cast<T>(total);
+}
+
+template <class T>
+T inner_product_block(const T* a, const T* b, size_t n, T init)
+{
+    typedef typename simd_detail::wrapping<T>::type U;
+    U total = static_cast<U>(init);
+    size_t i = 0;
+#if defined(__AVX2__)
+    typedef simd_detail::ops<T> op;
+    typename op::reg s0 = op::zero(), s1 = s0, s2 = s0, s3 = s0;
+    for (; i + 4 * op::LANES <= n; i += 4 * op::LANES) {
+        s0 = op::add(s0, op::mul(op::load(a + i), op::load(b + i)));
+        s1 = op::add(s1, op::mul(op::load(a + i + op::LANES), op::load(b + i + op::LANES)));
+        s2 = op::add(s2, op::mul(op::load(a + i + 2 * op::LANES), op::load(b + i + 2 * op::LANES)));
+        s3 = op::add(s3, op::mul(op::load(a + i + 3 * op::LANES), op::load(b + i + 3 * op::LANES)));
+    }
+    total += static_cast<U>(op::sum(op::add(op::add(s0, s1), op::add(s2, s3))));
+#endif
+    for (; i < n; ++i)
+        total += static_cast<U>(a[i]) * static_cast<U>(b[i]);
+    return static_cast<T>(total);
+}